@@ -0,0 +1,56 @@
+#include <bits/stdc++.h>
+#include "bellman_ford.h"
+#include "graph_binary.h"
+#include "output_writer.h"
+#include "thread_pool.h"
+using namespace std;
+
+// ---- Bellman-Ford ----
+// --threads=N   rounds on N threads (0: all cores; default: serial)
+// --source=S    distances from vertex S (default 1)
+// [input]       text edge list (1-indexed) or binary graph file
+//               (default: text on stdin)
+// Edges are directed, u -> v, and weights may be negative. Prints one
+// "v dist" line per vertex, "inf" for unreachable ones, or the vertices of
+// a negative cycle reachable from S if there is one.
+int main(int argc, char** argv) {
+    int threads = -1;
+    int source = 1;
+    const char* input = nullptr;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) threads = atoi(arg.c_str() + 10);
+        else if (arg.rfind("--source=", 0) == 0) source = atoi(arg.c_str() + 9);
+        else input = argv[i];
+    }
+    LoadedGraph<WeightedEdge<long long>> in;
+    if (!in.loadEdges(input, 1)) {
+        cerr << (input ? input : "stdin") << ": " << in.error << "\n";
+        return 1;
+    }
+    if (source < 1 || source > in.n) {
+        cerr << "source " << source << " out of range 1.." << in.n << "\n";
+        return 1;
+    }
+
+    unique_ptr<ThreadPool> pool;
+    if (threads >= 0) pool.reset(new ThreadPool(threads));
+    BellmanFordEngine bf(in.n, in.edges, pool.get());
+    in.dropEdges();
+    bf.run({source - 1});
+
+    BufferedWriter out;
+    if (bf.negativeCycle()) {
+        out << "Negative cycle:";
+        for (int v : bf.cycle()) out << ' ' << v + 1;
+        out << ' ' << bf.cycle()[0] + 1 << '\n';
+        return 0;
+    }
+    for (int v = 0; v < in.n; v++) {
+        out << v + 1 << ' ';
+        if (bf.reached(v)) out << bf.dist(v);
+        else out << "inf";
+        out << '\n';
+    }
+    return 0;
+}
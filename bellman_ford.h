@@ -0,0 +1,393 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define BELLMAN_FORD_X86 1
+#endif
+#include "graph.h"
+#include "thread_pool.h"
+
+// Bellman-Ford shortest paths with negative weights, over the same edge
+// records the MST engines take (EdgeT with members u, v, w, 0-indexed), read
+// as directed arcs u -> v: an undirected edge of negative weight would be a
+// negative cycle by itself.
+//
+//   BellmanFordEngine bf(n, edges, &pool);   // pool optional
+//   bf.run({s});
+//   if (bf.negativeCycle()) bf.cycle(); else bf.dist(v), bf.path(v)
+//
+// The rounds pull rather than push: every arc is stored once, grouped by
+// target (an in-arc CSR), and a round recomputes a vertex as the minimum
+// of dist[u] + w over its in-arcs. That inner loop is a gather, an add and
+// a compare per arc, done four arcs at a time with AVX2 where the CPU has
+// it, and since every vertex writes only its own entry the threads need no
+// atomics. A round runs in two parallel phases, compute then apply, so it
+// reads only the previous round's distances (Jacobi order) and the result
+// does not depend on the thread count.
+//
+// Which vertices a round recomputes follows the SPFA idea: only those with
+// an in-neighbour whose distance changed in the round before. The engine
+// keeps that frontier and marks its out-neighbours in a bitmap through an
+// out-arc CSR, then walks the bitmap in vertex order, so the in-arc lists
+// are still read front to back. Once the frontier's out-arcs are a
+// sizeable share of the graph, marking costs more than it saves and the
+// round recomputes every vertex instead. The run ends as soon as a round
+// changes nothing.
+//
+// Negative cycles: a vertex still changing in round n means one is
+// reachable. From round n on, any vertex still relaxing leads back to a
+// negative cycle in the parent graph, which is checked every round until
+// one is found. The parent graph is also searched whenever the round count
+// reaches a power of two from 16 on, so a negative cycle usually ends the
+// run long before round n. When negativeCycle() is set the distances are
+// meaningless.
+//
+// Distances are long long; |weight| times n must stay below 2^61. The CSR
+// build is a serial counting sort, done once per graph; a batch of runs
+// reuses it and the distance arrays.
+
+namespace bellman_ford_detail {
+
+// "not reached": far enough from LLONG_MAX that adding a weight is safe
+const long long INF = LLONG_MAX / 4;
+const std::size_t NONE = SIZE_MAX;
+
+inline bool detectAVX2() {
+#ifdef BELLMAN_FORD_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+// whether rounds use the AVX2 kernel; benchmarks may clear it to compare
+inline bool& simd() {
+    static bool on = detectAVX2();
+    return on;
+}
+
+// best = min(best, dist[src[a]] + w[a]) over reached sources, a in [b, e);
+// arc = the first arc attaining a new best, left alone if none does.
+// W is the stored weight, int or long long.
+template <class W>
+void scalarPull(const long long* dist, const int* src, const W* w, std::size_t b, std::size_t e, long long& best,
+                std::size_t& arc) {
+    for (std::size_t a = b; a < e; a++) {
+        long long d = dist[src[a]];
+        if (d < INF && d + w[a] < best) {
+            best = d + w[a];
+            arc = a;
+        }
+    }
+}
+
+#ifdef BELLMAN_FORD_X86
+// four stored weights as 64-bit lanes
+__attribute__((target("avx2"))) inline __m256i loadWeights(const long long* w) {
+    return _mm256_loadu_si256((const __m256i*)w);
+}
+__attribute__((target("avx2"))) inline __m256i loadWeights(const int* w) {
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)w));
+}
+
+// Same result as scalarPull: each lane keeps the first arc attaining its
+// own minimum, and the lanes are merged by (distance, arc).
+template <class W>
+__attribute__((target("avx2"))) void avx2Pull(const long long* dist, const int* src, const W* w, std::size_t b,
+                                              std::size_t e, long long& best, std::size_t& arc) {
+    std::size_t a = b;
+    if (e - b >= 4) {
+        const __m256i inf = _mm256_set1_epi64x(INF), four = _mm256_set1_epi64x(4);
+        __m256i vbest = _mm256_set1_epi64x(best), varc = _mm256_set1_epi64x(-1);
+        __m256i lane = _mm256_setr_epi64x((long long)a, (long long)a + 1, (long long)a + 2, (long long)a + 3);
+        for (; a + 4 <= e; a += 4) {
+            __m128i idx = _mm_loadu_si128((const __m128i*)(src + a));
+            __m256i d = _mm256_i32gather_epi64((const long long*)dist, idx, 8);
+            __m256i c = _mm256_add_epi64(d, loadWeights(w + a));
+            __m256i take = _mm256_and_si256(_mm256_cmpgt_epi64(inf, d), _mm256_cmpgt_epi64(vbest, c));
+            vbest = _mm256_blendv_epi8(vbest, c, take);
+            varc = _mm256_blendv_epi8(varc, lane, take);
+            lane = _mm256_add_epi64(lane, four);
+        }
+        alignas(32) long long lb[4], la[4];
+        _mm256_store_si256((__m256i*)lb, vbest);
+        _mm256_store_si256((__m256i*)la, varc);
+        for (int i = 0; i < 4; i++) {
+            if (la[i] < 0) continue;
+            if (lb[i] < best || (lb[i] == best && (std::size_t)la[i] < arc)) {
+                best = lb[i];
+                arc = (std::size_t)la[i];
+            }
+        }
+    }
+    scalarPull(dist, src, w, a, e, best, arc);
+}
+#endif
+
+template <class W>
+void pull(bool vector, const long long* dist, const int* src, const W* w, std::size_t b, std::size_t e,
+          long long& best, std::size_t& arc) {
+#ifdef BELLMAN_FORD_X86
+    if (vector) {
+        avx2Pull(dist, src, w, b, e, best, arc);
+        return;
+    }
+#endif
+    (void)vector;
+    scalarPull(dist, src, w, b, e, best, arc);
+}
+
+}  // namespace bellman_ford_detail
+
+class BellmanFordEngine {
+public:
+    template <class EdgeT>
+    BellmanFordEngine(int n, ArrayView<EdgeT> edges, ThreadPool* pool = nullptr)
+        : n(n),
+          pool(pool),
+          inOffset(n + 1, 0),
+          outOffset(n + 1, 0),
+          distance(n, bellman_ford_detail::INF),
+          parentOf(n, -1),
+          cand(n),
+          candArc(n),
+          dirty(new std::atomic<std::uint64_t>[(n + 63) / 64]()),
+          local(threads()),
+          localScanned(threads()) {
+        static_assert(std::is_integral<decltype(EdgeT::w)>::value, "BellmanFordEngine needs integer weights");
+        std::size_t m = edges.size();
+        for (const EdgeT& e : edges) {
+            inOffset[e.v + 1]++;
+            outOffset[e.u + 1]++;
+        }
+        for (int v = 0; v < n; v++) {
+            inOffset[v + 1] += inOffset[v];
+            outOffset[v + 1] += outOffset[v];
+        }
+        narrow = std::all_of(edges.begin(), edges.end(), [](const EdgeT& e) {
+            return (long long)e.w >= INT_MIN && (long long)e.w <= INT_MAX;
+        });
+        inSource.resize(m);
+        if (narrow) weight32.resize(m);
+        else weight64.resize(m);
+        outTarget.resize(m);
+        std::vector<std::size_t> in(inOffset.begin(), inOffset.end() - 1), out(outOffset.begin(), outOffset.end() - 1);
+        for (const EdgeT& e : edges) {
+            std::size_t a = in[e.v]++;
+            inSource[a] = e.u;
+            if (narrow) weight32[a] = (int)e.w;
+            else weight64[a] = (long long)e.w;
+            outTarget[out[e.u]++] = e.v;
+        }
+        // thread ranges, balanced by in-arcs plus vertices and aligned to
+        // the 64-vertex words of the dirty bitmap
+        std::size_t T = threads(), work = m + n;
+        cut.assign(T + 1, n);
+        for (std::size_t t = 0; t < T; t++) {
+            std::size_t goal = work * t / T;
+            int lo = 0, hi = n;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (inOffset[mid] + mid < goal) lo = mid + 1;
+                else hi = mid;
+            }
+            cut[t] = std::min<std::size_t>(n, (std::size_t)lo / 64 * 64);
+        }
+    }
+
+    BellmanFordEngine(const BellmanFordEngine&) = delete;
+    BellmanFordEngine& operator=(const BellmanFordEngine&) = delete;
+
+    // Distances from the nearest of the sources (0-indexed). Returns the
+    // number of rounds.
+    int run(const std::vector<int>& sources) {
+        using namespace bellman_ford_detail;
+        std::fill(distance.begin(), distance.end(), INF);
+        std::fill(parentOf.begin(), parentOf.end(), -1);
+        active.clear();
+        loop.clear();
+        arcsScanned = 0;
+        for (int s : sources) {
+            if (distance[s] == 0) continue;
+            distance[s] = 0;
+            active.push_back(s);
+        }
+        bool vector = simd();
+        roundCount = 0;
+        while (!active.empty()) {
+            roundCount++;
+            std::size_t frontierArcs = 0;
+            for (int u : active) frontierArcs += outOffset[u + 1] - outOffset[u];
+            round(frontierArcs * DENSE_SHARE >= arcs(), vector);
+
+            bool check = roundCount >= n || (roundCount >= 16 && (roundCount & (roundCount - 1)) == 0);
+            if (!active.empty() && check && findCycle()) break;
+        }
+        return roundCount;
+    }
+
+    // LLONG_MAX if the last run did not reach v
+    long long dist(int v) const { return distance[v] == bellman_ford_detail::INF ? LLONG_MAX : distance[v]; }
+    bool reached(int v) const { return distance[v] != bellman_ford_detail::INF; }
+    // predecessor on a shortest path; -1 for sources and unreached vertices
+    int parent(int v) const { return parentOf[v]; }
+
+    // vertices from a source to t, empty if t was not reached; not
+    // meaningful after a negative cycle
+    std::vector<int> path(int t) const {
+        std::vector<int> p;
+        if (!reached(t)) return p;
+        for (int v = t; v != -1; v = parentOf[v]) p.push_back(v);
+        std::reverse(p.begin(), p.end());
+        return p;
+    }
+
+    bool negativeCycle() const { return !loop.empty(); }
+    // a negative cycle reachable from the sources, as vertices c0 -> c1 ->
+    // ... -> c0 starting at its smallest id; empty if there is none
+    const std::vector<int>& cycle() const { return loop; }
+
+    int rounds() const { return roundCount; }
+    // in-arcs the last run read, over all rounds
+    std::size_t scanned() const { return arcsScanned; }
+    int vertices() const { return n; }
+    std::size_t arcs() const { return inSource.size(); }
+
+private:
+    // a round recomputes every vertex once the frontier's out-arcs are at
+    // least 1 / DENSE_SHARE of all arcs
+    static constexpr std::size_t DENSE_SHARE = 16;
+
+    int n;
+    ThreadPool* pool;
+    std::vector<std::size_t> inOffset, outOffset, cut;
+    std::vector<int> inSource, outTarget;
+    // in-arc weights, 32-bit when they all fit: the rounds are bound by
+    // memory traffic, and that makes an arc 8 bytes instead of 12
+    bool narrow;
+    std::vector<int> weight32;
+    std::vector<long long> weight64;
+    std::vector<long long> distance;
+    std::vector<int> parentOf;
+    // per vertex recomputed this round: its new distance and the arc it
+    // came through
+    std::vector<long long> cand;
+    std::vector<std::size_t> candArc;
+    // vertices to recompute this round, one bit each
+    std::unique_ptr<std::atomic<std::uint64_t>[]> dirty;
+    std::vector<int> active, loop;
+    std::vector<std::vector<int>> local;  // per-thread lists of changed vertices
+    std::vector<std::size_t> localScanned;
+    int roundCount = 0;
+    std::size_t arcsScanned = 0;
+
+    std::size_t threads() const { return pool ? pool->size() : 1; }
+    std::size_t firstWord(std::size_t t) const { return (cut[t] + 63) / 64; }
+
+    // fn(v) for the vertices of thread t's range, all of them or just the
+    // dirty ones; ranges start at multiples of 64, so no two threads share
+    // a word of the bitmap
+    template <class F>
+    void forVertices(bool dense, unsigned t, F fn) {
+        if (dense) {
+            for (std::size_t v = cut[t]; v < cut[t + 1]; v++) fn((int)v);
+            return;
+        }
+        for (std::size_t w = firstWord(t); w < firstWord(t + 1); w++)
+            for (std::uint64_t bits = dirty[w].load(std::memory_order_relaxed); bits; bits &= bits - 1)
+                fn((int)(w * 64 + __builtin_ctzll(bits)));
+    }
+
+    template <class F>
+    void onThreads(F fn) {
+        if (pool) pool->run(fn);
+        else fn(0);
+    }
+
+    // one round: mark (sparse rounds only), compute, apply
+    void round(bool dense, bool vector) {
+        using namespace bellman_ford_detail;
+        if (!dense) {
+            auto markAll = [&](unsigned, std::size_t lo, std::size_t hi) {
+                for (std::size_t i = lo; i < hi; i++) {
+                    int u = active[i];
+                    for (std::size_t a = outOffset[u]; a < outOffset[u + 1]; a++) {
+                        int v = outTarget[a];
+                        std::uint64_t bit = 1ull << (v % 64);
+                        if (!(dirty[v / 64].load(std::memory_order_relaxed) & bit))
+                            dirty[v / 64].fetch_or(bit, std::memory_order_relaxed);
+                    }
+                }
+            };
+            if (pool) pool->for_chunks(active.size(), markAll);
+            else markAll(0, 0, active.size());
+        }
+        auto computeAll = [&](unsigned t, const auto* weight) {
+            std::size_t scannedHere = 0;
+            forVertices(dense, t, [&](int v) {
+                long long best = distance[v];
+                std::size_t arc = NONE;
+                pull(vector, distance.data(), inSource.data(), weight, inOffset[v], inOffset[v + 1], best, arc);
+                cand[v] = best;
+                candArc[v] = arc;
+                scannedHere += inOffset[v + 1] - inOffset[v];
+            });
+            localScanned[t] = scannedHere;
+        };
+        onThreads([&](unsigned t) {
+            if (narrow) computeAll(t, weight32.data());
+            else computeAll(t, weight64.data());
+        });
+        onThreads([&](unsigned t) {
+            local[t].clear();
+            forVertices(dense, t, [&](int v) {
+                if (candArc[v] == NONE) return;
+                distance[v] = cand[v];
+                parentOf[v] = inSource[candArc[v]];
+                local[t].push_back(v);
+            });
+            if (!dense)
+                for (std::size_t w = firstWord(t); w < firstWord(t + 1); w++)
+                    dirty[w].store(0, std::memory_order_relaxed);
+        });
+        for (std::size_t s : localScanned) arcsScanned += s;
+
+        // the next frontier: the changed vertices, in vertex order
+        std::size_t T = threads();
+        std::vector<std::size_t> at(T + 1, 0);
+        for (std::size_t t = 0; t < T; t++) at[t + 1] = at[t] + local[t].size();
+        active.resize(at[T]);
+        onThreads([&](unsigned t) { std::copy(local[t].begin(), local[t].end(), active.begin() + at[t]); });
+    }
+
+    // Looks for a cycle of parent pointers; any such cycle is negative.
+    // O(n): every vertex is walked over once.
+    bool findCycle() {
+        std::vector<int> seen(n, -1);  // the start of the walk that passed by
+        for (int s = 0; s < n; s++) {
+            int x = s;
+            while (x != -1 && seen[x] == -1) {
+                seen[x] = s;
+                x = parentOf[x];
+            }
+            if (x == -1 || seen[x] != s) continue;
+            // x is on the cycle; parents lead backwards along it
+            for (int y = x;;) {
+                loop.push_back(y);
+                y = parentOf[y];
+                if (y == x) break;
+            }
+            std::reverse(loop.begin(), loop.end());
+            std::rotate(loop.begin(), std::min_element(loop.begin(), loop.end()), loop.end());
+            return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <random>
+#include <vector>
+#include "graph.h"
+
+// Graph generators shared by the heap benchmarks (prim_bench,
+// dijkstra_bench).
+
+// random connected graph: a random spanning tree plus extra random edges,
+// weights in [1, 10^6]; Graph is any type with CsrGraph's build(n, edges)
+template <class Graph, class W = long long>
+Graph randomGraph(int n, long long m, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<WeightedEdge<W>> edges;
+    edges.reserve(m);
+    auto add = [&](int u, int v) { edges.push_back({u, v, (W)(rng() % 1000000) + 1}); };
+    for (int v = 1; v < n; v++) add((int)(rng() % v), v);
+    for (long long i = n - 1; i < m; i++) {
+        int u = (int)(rng() % n), v = (int)(rng() % n);
+        if (u != v) add(u, v);
+    }
+    return Graph::build(n, ArrayView<WeightedEdge<W>>(edges));
+}
@@ -0,0 +1,57 @@
+// Strong scaling of the parallel Boruvka engine (parallel_boruvka.h): one
+// fixed random graph, solved with 1, 2, 4, ... threads.
+//
+//   g++ -O2 -std=c++17 -pthread boruvka_bench.cpp -o boruvka_bench
+//   ./boruvka_bench [n] [m] [max_threads] [rounds]
+//
+// Defaults: n = 2^20, m = 8n, max_threads = hardware threads, 3 rounds.
+// For each thread count prints the best wall time, the speedup and
+// parallel efficiency against one thread, and the number of phases; every
+// run must find the same forest weight.
+#include <bits/stdc++.h>
+#include "graph.h"
+#include "parallel_boruvka.h"
+#include "thread_pool.h"
+using namespace std;
+
+int main(int argc, char** argv) {
+    int n = argc > 1 ? atoi(argv[1]) : 1 << 20;
+    long long m = argc > 2 ? atoll(argv[2]) : 8LL * n;
+    unsigned maxThreads = argc > 3 ? (unsigned)atoi(argv[3]) : max(1u, thread::hardware_concurrency());
+    int rounds = argc > 4 ? atoi(argv[4]) : 3;
+
+    mt19937_64 rng(11);
+    vector<WeightedEdge<long long>> edges(m);
+    for (auto& e : edges) {
+        e.u = (int)(rng() % n);
+        e.v = (int)(rng() % n);
+        e.w = (long long)(rng() % 1000000000);
+    }
+    printf("n=%d m=%lld, hardware threads %u\n", n, m, thread::hardware_concurrency());
+    printf("%8s %10s %8s %10s %7s\n", "threads", "time_ms", "speedup", "efficiency", "phases");
+
+    double base = 0;
+    long long weight = -1;
+    vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    for (unsigned t : counts) {
+        ThreadPool pool(t);
+        double best = 1e18;
+        size_t phases = 0;
+        for (int r = 0; r < rounds; r++) {
+            auto t0 = chrono::steady_clock::now();
+            BoruvkaResult<long long> res = parallelBoruvkaMST(n, ArrayView<WeightedEdge<long long>>(edges), pool);
+            best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+            phases = res.phases.size();
+            if (weight == -1) weight = res.totalWeight;
+            if (res.totalWeight != weight) {
+                fprintf(stderr, "weight mismatch with %u threads: %lld vs %lld\n", t, res.totalWeight, weight);
+                return 1;
+            }
+        }
+        if (t == 1) base = best;
+        printf("%8u %10.1f %8.2f %9.0f%% %7zu\n", t, best, base / best, 100 * base / best / t, phases);
+    }
+    return 0;
+}
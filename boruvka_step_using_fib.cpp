@@ -1,4 +1,9 @@
 #include <bits/stdc++.h>
+#include "dsu.h"
+#include "fib_heap.h"
+#include "graph_binary.h"
+#include "output_writer.h"
+#include "parallel_boruvka.h"
 using namespace std;
 using ll = long long;
 
@@ -9,240 +14,58 @@ struct Edge {
     Edge(int _u, int _v, ll _w): u(_u), v(_v), w(_w) {}
 };
 
-// ----------------- Minimal Fibonacci Heap (insert, extractMin, merge) -----------------
-struct FibNode {
-    int edgeIndex;    // index into global edge list
-    ll key;           // weight
-    FibNode *left, *right, *child, *parent;
-    int degree;
-    bool mark;
-    FibNode(int ei, ll k) : edgeIndex(ei), key(k),
-        left(this), right(this), child(nullptr), parent(nullptr),
-        degree(0), mark(false) {}
-};
-
-struct FibHeap {
-    FibNode *minNode;
-    int n;
-
-    FibHeap(): minNode(nullptr), n(0) {}
-
-    bool empty() const { return minNode == nullptr; }
+// ----------------- Fibonacci Heap -----------------
+// key = weight, payload = index into global edge list
+// the per-component heaps of a step share one caller-owned pool
+using EdgeHeap = FibHeap<ll, int>;
 
-    void insertNode(FibNode *x) {
-        if (!minNode) {
-            minNode = x;
-            x->left = x->right = x;
-        } else {
-            // insert x into root list (right of minNode)
-            x->left = minNode;
-            x->right = minNode->right;
-            minNode->right->left = x;
-            minNode->right = x;
-            if (x->key < minNode->key) minNode = x;
-        }
-        ++n;
-    }
-
-    FibNode* makeNode(int edgeIndex, ll key) {
-        return new FibNode(edgeIndex, key);
-    }
-
-    // merge heaps: splice root lists and update min and size
-    static FibHeap* mergeHeaps(FibHeap* A, FibHeap* B) {
-        if (!A) return B;
-        if (!B) return A;
-        // splice root lists
-        FibNode* aRight = A->minNode->right;
-        FibNode* bLeft  = B->minNode->left;
-
-        A->minNode->right = B->minNode;
-        B->minNode->left  = A->minNode;
-        aRight->left = bLeft;
-        bLeft->right = aRight;
-
-        if (B->minNode->key < A->minNode->key) A->minNode = B->minNode;
-        A->n += B->n;
-        // delete B container but keep nodes
-        delete B;
-        return A;
-    }
-
-    // Helper: remove node x from root list (assumes x is in some list)
-    void removeFromRootList(FibNode* x) {
-        x->left->right = x->right;
-        x->right->left = x->left;
-    }
-
-    // link y under x (y becomes child of x)
-    void link(FibNode* y, FibNode* x) {
-        removeFromRootList(y);
-        // make y a child of x
-        y->parent = x;
-        if (!x->child) {
-            x->child = y;
-            y->left = y->right = y;
-        } else {
-            // insert y into child's root list
-            y->left = x->child;
-            y->right = x->child->right;
-            x->child->right->left = y;
-            x->child->right = y;
-        }
-        x->degree++;
-        y->mark = false;
-    }
-
-    // Consolidate after extractMin
-    void consolidate() {
-        if (!minNode) return;
-        int D = std::max(16, (int)(log2(max(1, n)) + 2)); // safe bound
-        vector<FibNode*> A(D, nullptr);
-
-        // gather root list nodes
-        vector<FibNode*> roots;
-        FibNode* cur = minNode;
-        do {
-            roots.push_back(cur);
-            cur = cur->right;
-        } while (cur != minNode);
-
-        for (FibNode* w : roots) {
-            FibNode* x = w;
-            int d = x->degree;
-            while (d >= (int)A.size()) A.resize(A.size()*2, nullptr);
-            while (A[d] != nullptr) {
-                FibNode* y = A[d];
-                if (x->key > y->key) swap(x, y);
-                link(y, x);
-                A[d] = nullptr;
-                ++d;
-                if (d >= (int)A.size()) A.resize(A.size()*2, nullptr);
-            }
-            A[d] = x;
-        }
-
-        // rebuild root list and find new min
-        minNode = nullptr;
-        for (FibNode* node : A) {
-            if (!node) continue;
-            node->left = node->right = node;
-            if (!minNode) {
-                minNode = node;
-            } else {
-                // insert node into minNode's root list
-                node->left = minNode;
-                node->right = minNode->right;
-                minNode->right->left = node;
-                minNode->right = node;
-                if (node->key < minNode->key) minNode = node;
-            }
-        }
-    }
-
-    // Extract min root and return it
-    FibNode* extractMin() {
-        FibNode* z = minNode;
-        if (!z) return nullptr;
-
-        // move children of z to root list
-        if (z->child) {
-            vector<FibNode*> children;
-            FibNode* c = z->child;
-            do {
-                children.push_back(c);
-                c = c->right;
-            } while (c != z->child);
-
-            for (FibNode* x : children) {
-                x->parent = nullptr;
-                // insert x into root list (right of minNode)
-                x->left = minNode;
-                x->right = minNode->right;
-                minNode->right->left = x;
-                minNode->right = x;
-            }
-        }
-
-        // remove z from root list
-        if (z->right == z) {
-            minNode = nullptr;
-        } else {
-            removeFromRootList(z);
-            minNode = z->right;
-            consolidate();
-        }
-        --n;
-        // detach z fields so it is a standalone node
-        z->left = z->right = z;
-        z->child = nullptr;
-        z->parent = nullptr;
-        z->degree = 0;
-        z->mark = false;
-        return z;
-    }
-
-    // insert an edge (index) with key weight
-    void insertEdge(int edgeIndex, ll weight) {
-        FibNode* node = makeNode(edgeIndex, weight);
-        insertNode(node);
-    }
-};
-
-// ----------------- DSU -----------------
-struct DSU {
-    int n;
-    vector<int> parent, r;
-    DSU(int n=0): n(n), parent(n), r(n,0) {
-        for (int i=0;i<n;i++) parent[i]=i;
-    }
-    int find(int x){ return parent[x]==x?x:parent[x]=find(parent[x]); }
-    int unite(int a,int b){
-        a=find(a); b=find(b);
-        if(a==b) return a;
-        if(r[a]<r[b]) swap(a,b);
-        parent[b]=a;
-        if(r[a]==r[b]) r[a]++;
-        return a; // return new root
-    }
-};
+// adjacency with the input edge index of every arc
+using Graph = CsrGraph<ll>;
 
 // ----------------- Boruvka Step Using FibHeap -----------------
 // Performs one Boruvka phase: selects cheapest outgoing edge per component
 // and unions components as chosen. Returns edges added in this step.
+// Heap nodes come from `pool`, which is reset at the start of every step so
+// repeated steps reuse the same slabs.
 vector<int> boruvka_step_using_fibheap(
-    int n,
-    const vector<Edge>& edges,
+    const Graph& g,
+    ArrayView<Edge> edges,
     DSU &dsu,
+    EdgeHeap::Pool &pool,
     ll &added_weight,
     vector<pair<int,int>> &added_edges // pairs (edgeIndex, dummy)
 ) {
+    int n = g.n;
     added_weight = 0;
     added_edges.clear();
 
-    // map each component root to its FibHeap pointer
-    vector<FibHeap*> heaps(n, nullptr);
-
-    // Build heaps: for each undirected edge (u,v), if they lie in different components,
-    // insert edge index into both component heaps.
-    for (int ei = 0; ei < (int)edges.size(); ++ei) {
-        int u = edges[ei].u;
-        int v = edges[ei].v;
-        ll w = edges[ei].w;
-        int cu = dsu.find(u);
-        int cv = dsu.find(v);
-        if (cu == cv) continue;
-        if (!heaps[cu]) heaps[cu] = new FibHeap();
-        if (!heaps[cv]) heaps[cv] = new FibHeap();
-        heaps[cu]->insertEdge(ei, w);
-        heaps[cv]->insertEdge(ei, w);
+    // one heap per component root
+    pool.reset();
+    pool.reserve(g.arcs());
+    vector<EdgeHeap> heaps;
+    heaps.reserve(n);
+    for (int i = 0; i < n; i++) heaps.emplace_back(pool);
+
+    // component of every vertex, looked up once instead of twice per edge
+    vector<int> comp(n);
+    for (int x = 0; x < n; x++) comp[x] = dsu.find(x);
+
+    // Build heaps by streaming each vertex's arcs: an arc that leaves u's
+    // component goes into that component's heap, so every crossing edge
+    // lands in the heaps of both of its components.
+    for (int u = 0; u < n; ++u) {
+        int cu = comp[u];
+        for (size_t a = g.begin(u); a < g.end(u); ++a) {
+            if (comp[g.target[a]] == cu) continue;
+            heaps[cu].insert(g.weight[a], g.edgeId[a]);
+        }
     }
 
     int comps = 0;
     vector<int> compRoots;
     compRoots.reserve(n);
     for (int i=0;i<n;i++){
-        if (dsu.find(i)==i){
+        if (comp[i]==i){
             comps++;
             compRoots.push_back(i);
         }
@@ -252,12 +75,9 @@ vector<int> boruvka_step_using_fibheap(
     vector<int> chosenEdge(n, -1); // chosen edge index per component root
 
     for (int root : compRoots) {
-        FibHeap* H = heaps[root];
-        if (!H) continue;
-        while (!H->empty()) {
-            FibNode* mn = H->extractMin();
-            int ei = mn->edgeIndex;
-            delete mn; // not needed any more
+        EdgeHeap& H = heaps[root];
+        while (!H.empty()) {
+            int ei = H.extract_min().payload;
             int u = edges[ei].u, v = edges[ei].v;
             int cu = dsu.find(u), cv = dsu.find(v);
             // If edge becomes internal (both endpoints in same component), skip it
@@ -285,28 +105,10 @@ vector<int> boruvka_step_using_fibheap(
         added_weight += edges[ei].w;
 
         // After union, merge heaps of old roots into new root so next phase can reuse them.
-        FibHeap* H1 = heaps[ru];
-        FibHeap* H2 = heaps[rv];
-        if (ru == newRoot && rv == newRoot) {
-            // both were same -- nothing
-        } else {
-            int keep = newRoot;
-            int other = (keep == ru ? rv : ru);
-            // if one heap is null, set heap to the other
-            if (!heaps[keep]) heaps[keep] = heaps[other];
-            else if (heaps[other]) heaps[keep] = FibHeap::mergeHeaps(heaps[keep], heaps[other]);
-            heaps[other] = nullptr;
-        }
-    }
-
-    // cleanup leftover heaps
-    for (int i=0;i<n;i++){
-        if (heaps[i]) {
-            // free nodes are not explicitly freed here (for brevity) — production code should free heap nodes
-            delete heaps[i];
-            heaps[i] = nullptr;
-        }
+        int other = (newRoot == ru ? rv : ru);
+        heaps[newRoot].meld(heaps[other]);
     }
+    // leftover nodes stay in the pool until its next reset()
 
     // Return vector of chosen edge indices per component (optional)
     // We return a list of edge indices that were chosen (edgeTaken true)
@@ -315,22 +117,224 @@ vector<int> boruvka_step_using_fibheap(
     return result;
 }
 
-// ----------------- Example usage -----------------
-int main(){
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+// ----------------- Boruvka Step, heap-free -----------------
+// Same step without heaps: one pass over the edge list keeps the cheapest
+// outgoing edge of every component in a flat best[] array, ties broken by
+// the smaller edge index. That order is a strict total order on the edges,
+// so the chosen edges never close a cycle and the result is deterministic.
+// No allocation per edge and no CSR needed; the heap variant above stays
+// for callers that keep the heaps between steps.
+vector<int> boruvka_step_scan(
+    ArrayView<Edge> edges,
+    DSU &dsu,
+    ll &added_weight
+) {
+    int n = dsu.n;
+    added_weight = 0;
+    vector<int> comp(n);
+    for (int x = 0; x < n; x++) comp[x] = dsu.find(x);
+
+    // edges are scanned in index order, so a strict < keeps the lower index
+    vector<int> best(n, -1); // per component root
+    for (size_t i = 0; i < edges.size(); i++) {
+        int cu = comp[edges[i].u], cv = comp[edges[i].v];
+        if (cu == cv) continue;
+        ll w = edges[i].w;
+        if (best[cu] == -1 || w < edges[best[cu]].w) best[cu] = (int)i;
+        if (best[cv] == -1 || w < edges[best[cv]].w) best[cv] = (int)i;
+    }
+
+    vector<int> result;
+    for (int c = 0; c < n; c++) {
+        int ei = best[c];
+        if (ei == -1) continue;
+        int ru = dsu.find(edges[ei].u), rv = dsu.find(edges[ei].v);
+        if (ru == rv) continue; // picked by both of its components
+        dsu.unite(ru, rv);
+        result.push_back(ei);
+        added_weight += edges[ei].w;
+    }
+    sort(result.begin(), result.end());
+    return result;
+}
+
+// ----------------- Contraction -----------------
+// Relabels every edge to the components of `dsu`, drops the ones that became
+// self-loops and keeps only the lightest of each bundle of parallel edges, so
+// the next step sees one vertex per component and at most one edge per pair
+// of components. Edges are bucketed by their smaller endpoint and each bucket
+// is deduplicated through slot[], O(n + m). orig[i] maps the surviving edge i
+// back to the input edge it stands for (`prevOrig` does the same for `edges`;
+// empty means the identity). Returns the number of components.
+int contract_edges(
+    ArrayView<Edge> edges,
+    const vector<int>& prevOrig,
+    DSU &dsu,
+    vector<Edge> &out,
+    vector<int> &orig
+) {
+    int n = dsu.n;
+    vector<int> label(n, -1);
+    int comps = 0;
+    for (int x = 0; x < n; x++) {
+        int r = dsu.find(x);
+        if (label[r] == -1) label[r] = comps++;
+        label[x] = label[r];
+    }
+
+    vector<size_t> start(comps + 1, 0);
+    for (const Edge& e : edges) {
+        int lu = label[e.u], lv = label[e.v];
+        if (lu != lv) start[min(lu, lv) + 1]++;
+    }
+    for (int c = 0; c < comps; c++) start[c + 1] += start[c];
+    vector<int> bucket(start[comps]);
+    vector<size_t> fill(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < edges.size(); i++) {
+        int lu = label[edges[i].u], lv = label[edges[i].v];
+        if (lu != lv) bucket[fill[min(lu, lv)]++] = (int)i;
+    }
+
+    out.clear();
+    orig.clear();
+    vector<int> slot(comps, -1); // out index of the edge c -- v, per v
+    for (int c = 0; c < comps; c++) {
+        for (size_t k = start[c]; k < start[c + 1]; k++) {
+            const Edge& e = edges[bucket[k]];
+            int v = label[e.u] ^ label[e.v] ^ c;
+            int from = prevOrig.empty() ? bucket[k] : prevOrig[bucket[k]];
+            if (slot[v] == -1) {
+                slot[v] = (int)out.size();
+                out.emplace_back(c, v, e.w);
+                orig.push_back(from);
+            } else if (e.w < out[slot[v]].w) {
+                out[slot[v]].w = e.w;
+                orig[slot[v]] = from;
+            }
+        }
+        for (size_t k = start[c]; k < start[c + 1]; k++) {
+            const Edge& e = edges[bucket[k]];
+            slot[label[e.u] ^ label[e.v] ^ c] = -1;
+        }
+    }
+    return comps;
+}
+
+// ----------------- Boruvka MST -----------------
+// Runs Boruvka steps until no edge is left between components. After every
+// step the graph is physically contracted (contract_edges), so later steps
+// touch geometrically fewer vertices and edges. Steps are heap-free unless
+// `useHeap`, which also rebuilds the contracted CSR the heap step reads.
+// Returns the input edge indices of the MST (a spanning forest if the graph
+// is disconnected) in the order the steps added them.
+vector<int> boruvka_mst(
+    const Graph& g,
+    ArrayView<Edge> edges,
+    EdgeHeap::Pool &pool,
+    ll &total_weight,
+    bool phaseStats,
+    bool useHeap
+) {
+    total_weight = 0;
+    vector<int> mst;
+    vector<Edge> curEdges, nextEdges;
+    vector<int> orig, nextOrig;  // current edge -> input edge; empty in step 1
+    Graph contracted;
+    const Graph* cur = &g;
+    int n = g.n;
+    ArrayView<Edge> E = edges;
+    for (int phase = 1; !E.empty(); phase++) {
+        auto t0 = chrono::steady_clock::now();
+        DSU dsu(n);
+        ll w = 0;
+        vector<pair<int,int>> info;
+        vector<int> added = useHeap ? boruvka_step_using_fibheap(*cur, E, dsu, pool, w, info)
+                                    : boruvka_step_scan(E, dsu, w);
+        total_weight += w;
+        for (int ei : added) mst.push_back(orig.empty() ? ei : orig[ei]);
+
+        int comps = contract_edges(E, orig, dsu, nextEdges, nextOrig);
+        swap(curEdges, nextEdges);
+        swap(orig, nextOrig);
+        if (phaseStats) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            cerr << "phase " << phase << ": n " << n << ", m " << E.size() << ", added " << added.size()
+                 << " -> n " << comps << ", m " << curEdges.size() << ", " << ms << " ms\n";
+        }
+        E = curEdges;
+        n = comps;
+        if (useHeap && !E.empty()) {
+            contracted = Graph::build(n, E, true);
+            cur = &contracted;
+        }
+    }
+    return mst;
+}
 
-    int n, m;
+// ----------------- Example usage -----------------
+// --full:        run steps until the MST is complete (default: one step)
+// --heap:        use the Fibonacci heap step instead of the heap-free scan
+// --threads=N:   full MST with the parallel engine on N threads (0: all cores)
+// --phase-stats: with --full, per-phase sizes and times on stderr
+// --pool-stats:  node allocator counters on stderr
+// --binary-out:  write the chosen input edge indices instead of text
+// [input]        text edge list or binary graph file (default: text on stdin)
+int main(int argc, char** argv){
+    bool poolStats = false, binaryOut = false, full = false, phaseStats = false, useHeap = false;
+    int threads = -1;
+    const char* input = nullptr;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--pool-stats") poolStats = true;
+        else if (arg == "--binary-out") binaryOut = true;
+        else if (arg == "--full") full = true;
+        else if (arg == "--heap") useHeap = true;
+        else if (arg.rfind("--threads=", 0) == 0) threads = atoi(arg.c_str() + 10);
+        else if (arg == "--phase-stats") phaseStats = true;
+        else input = argv[i];
+    }
     // Input: n m
     // then m lines: u v w  (1-indexed)
-    if (!(cin >> n >> m)) return 0;
-    vector<Edge> edges;
-    edges.reserve(m);
-    for (int i=0;i<m;i++){
-        int u,v; ll w;
-        cin >> u >> v >> w;
-        --u; --v;
-        edges.emplace_back(u,v,w);
+    LoadedGraph<Edge> in;
+    if (!in.load(input, 1, true)) {
+        cerr << (input ? input : "stdin") << ": " << in.error << "\n";
+        return 1;
+    }
+    int n = in.n;
+    const Graph& g = in.g;
+    ArrayView<Edge> edges = in.edges;
+    EdgeHeap::Pool pool;
+    BufferedWriter out;
+
+    if (full || threads >= 0) {
+        ll total = 0;
+        vector<int> mst;
+        if (threads >= 0) {
+            ThreadPool workers(threads);
+            BoruvkaResult<ll> r = parallelBoruvkaMST(n, edges, workers);
+            total = r.totalWeight;
+            mst.swap(r.edges);
+            if (phaseStats) {
+                for (size_t i = 0; i < r.phases.size(); i++) {
+                    const BoruvkaPhase& p = r.phases[i];
+                    cerr << "phase " << i + 1 << ": n " << p.n << ", m " << p.m << ", added " << p.added << ", "
+                         << p.ms << " ms\n";
+                }
+            }
+        } else {
+            mst = boruvka_mst(g, edges, pool, total, phaseStats, useHeap);
+        }
+        if (poolStats) cerr << "pool: " << pool.stats() << "\n";
+        if (binaryOut) {
+            writeEdgeIndexList(out, mst);
+            return 0;
+        }
+        out << "Edges in MST: " << mst.size() << "\n";
+        out << "Total MST weight: " << total << "\n";
+        for (int ei : mst) {
+            out << edges[ei].u + 1 << " " << edges[ei].v + 1 << " " << edges[ei].w << "\n";
+        }
+        return 0;
     }
 
     DSU dsu(n);
@@ -338,12 +342,19 @@ int main(){
     vector<pair<int,int>> added_edges_info;
 
     // Perform a single Boruvka step
-    vector<int> edges_added = boruvka_step_using_fibheap(n, edges, dsu, added_weight, added_edges_info);
-
-    cout << "Edges added in this Boruvka step: " << edges_added.size() << "\n";
-    cout << "Total weight added: " << added_weight << "\n";
+    vector<int> edges_added = useHeap
+        ? boruvka_step_using_fibheap(g, edges, dsu, pool, added_weight, added_edges_info)
+        : boruvka_step_scan(edges, dsu, added_weight);
+    if (poolStats) cerr << "pool: " << pool.stats() << "\n";
+
+    if (binaryOut) {
+        writeEdgeIndexList(out, edges_added);
+        return 0;
+    }
+    out << "Edges added in this Boruvka step: " << edges_added.size() << "\n";
+    out << "Total weight added: " << added_weight << "\n";
     for (int ei : edges_added) {
-        cout << edges[ei].u + 1 << " " << edges[ei].v + 1 << " " << edges[ei].w << "\n";
+        out << edges[ei].u + 1 << " " << edges[ei].v + 1 << " " << edges[ei].w << "\n";
     }
 
     return 0;
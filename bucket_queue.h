@@ -0,0 +1,331 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Integer-key priority queues with the FibHeap / DaryHeap interface
+// (insert / decrease_key / extract_min), for Prim and Dijkstra when the
+// weights are integers in a known range. Both keep their elements in
+// intrusive doubly linked bucket lists, so decrease_key is an unlink and a
+// relink, O(1), with no comparisons.
+//
+// DialQueue: one bucket per key value over a circular window of `width`
+// keys starting at the last minimum extracted (or a smaller key inserted
+// since). Every finite key must lie less than width above that point,
+// which holds for
+//   Dijkstra:  width = max weight + 1 (keys are in [d, d + max weight],
+//              d the last distance extracted)
+//   Prim:      width = max weight - min weight + 1 (keys are edge weights)
+// extract_min looks forward from the last minimum for the next non-empty
+// bucket; an insert below it moves it back, so Prim's non-monotone keys
+// are fine. The look-ahead goes through a two-level occupancy bitmap (one
+// bit per bucket, one summary bit per 64-bucket word), so a sparse window,
+// like Prim's frontier over a wide weight range, is crossed 4096 buckets
+// at a time instead of one. The largest Key value is "not reached yet"
+// (Prim's eager seeding) and waits in a separate list until decreased.
+//
+// RadixHeap: monotone queue for Dijkstra when the range is too wide for
+// one bucket per value. Bucket i > 0 holds keys whose highest bit differing
+// from the last extracted minimum is bit i - 1, so there are 65 buckets
+// whatever the range; extract_min empties the lowest non-empty bucket into
+// the ones below it, each element moving O(log C) times in total. Keys
+// must never go below the last minimum extracted.
+
+// Dial's queue pays for its buckets and for scanning empty ones, so the
+// drivers pick it only up to this width.
+const std::uint64_t DIAL_MAX_WIDTH = 1 << 20;
+
+namespace bucket_queue_detail {
+
+// list end; FREE in prev marks a handle that is not in the queue
+const std::uint32_t NIL = 0xffffffffu, FREE = 0xfffffffeu;
+
+// per-handle storage and the intrusive lists shared by both queues
+template <class Key, class Payload>
+struct Items {
+    struct Item {
+        Key key;
+        std::uint32_t prev, next;
+    };
+    std::vector<Item> item;
+    std::vector<Payload> payload;
+    std::vector<std::uint32_t> free_ids;
+
+    void reserve(std::size_t count) {
+        item.reserve(count);
+        payload.reserve(count);
+    }
+
+    std::uint32_t create(const Key& k, Payload p) {
+        std::uint32_t x;
+        if (!free_ids.empty()) {
+            x = free_ids.back();
+            free_ids.pop_back();
+            payload[x] = std::move(p);
+        } else {
+            x = (std::uint32_t)item.size();
+            item.push_back({});
+            payload.push_back(std::move(p));
+        }
+        item[x].key = k;
+        return x;
+    }
+
+    void push(std::uint32_t& head, std::uint32_t x) {
+        item[x].prev = NIL;
+        item[x].next = head;
+        if (head != NIL) item[head].prev = x;
+        head = x;
+    }
+
+    void release(std::uint32_t x) {
+        item[x].prev = FREE;
+        free_ids.push_back(x);
+    }
+
+    void unlink(std::uint32_t& head, std::uint32_t x) {
+        Item& it = item[x];
+        if (it.prev != NIL) item[it.prev].next = it.next;
+        else head = it.next;
+        if (it.next != NIL) item[it.next].prev = it.prev;
+    }
+
+    void clear() {
+        item.clear();
+        payload.clear();
+        free_ids.clear();
+    }
+};
+
+}  // namespace bucket_queue_detail
+
+template <class Key, class Payload>
+class DialQueue {
+    static_assert(std::is_integral<Key>::value, "DialQueue needs integer keys");
+
+public:
+    using handle = std::uint32_t;
+
+    struct Entry {
+        Key key;
+        Payload payload;
+    };
+
+    explicit DialQueue(std::uint64_t width = 1)
+        : width(width ? width : 1), head(this->width, NIL), bits((this->width + 63) / 64), summary((bits.size() + 63) / 64) {}
+
+    bool empty() const { return finite == 0 && infinite == NIL; }
+    std::size_t size() const { return items.item.size() - items.free_ids.size(); }
+    const Key& key(handle x) const { return items.item[x].key; }
+    const Payload& payload(handle x) const { return items.payload[x]; }
+    void reserve(std::size_t count) { items.reserve(count); }
+
+    handle insert(const Key& k, Payload p) {
+        handle x = items.create(k, std::move(p));
+        link(x);
+        return x;
+    }
+
+    // a k that is not smaller than the current key is ignored
+    void decrease_key(handle x, const Key& k) {
+        Key& cur = items.item[x].key;
+        if (!(k < cur)) return;
+        unlink(x);
+        cur = k;
+        link(x);
+    }
+
+    Entry extract_min() {
+        handle x;
+        if (finite == 0) {
+            x = infinite;
+            items.unlink(infinite, x);
+        } else {
+            std::uint64_t from = bucket(low), b = nextOccupied(from);
+            if (b == width) b = nextOccupied(0);  // wrapped around the window
+            low += (Key)(b >= from ? b - from : b + width - from);
+            x = head[b];
+            items.unlink(head[b], x);
+            if (head[b] == NIL) clearBit(b);
+            finite--;
+        }
+        items.release(x);
+        return Entry{items.item[x].key, std::move(items.payload[x])};
+    }
+
+    // O(elements ever held), not O(width)
+    void clear() {
+        for (const auto& it : items.item) {
+            if (it.prev == bucket_queue_detail::FREE || it.key == INF) continue;
+            std::uint64_t b = bucket(it.key);
+            head[b] = NIL;
+            bits[b / 64] = 0;
+            summary[b / 4096] = 0;
+        }
+        items.clear();
+        finite = 0;
+        infinite = NIL;
+    }
+
+private:
+    static constexpr std::uint32_t NIL = bucket_queue_detail::NIL;
+    static constexpr Key INF = std::numeric_limits<Key>::max();
+
+    std::uint64_t width;
+    std::vector<handle> head;  // per bucket
+    std::vector<std::uint64_t> bits, summary;  // non-empty buckets, non-zero words of bits
+    handle infinite = NIL;     // keys equal to INF
+    std::size_t finite = 0;    // elements in the buckets
+    Key low = 0;               // no finite key is below it
+    bucket_queue_detail::Items<Key, Payload> items;
+
+    std::uint64_t bucket(Key k) const {
+        Key r = k % (Key)width;
+        return (std::uint64_t)(r < 0 ? r + (Key)width : r);
+    }
+
+    void link(handle x) {
+        Key k = items.item[x].key;
+        if (k == INF) {
+            items.push(infinite, x);
+            return;
+        }
+        if (finite == 0 || k < low) low = k;
+        assert(k - low < (Key)width && "DialQueue key outside the window");
+        std::uint64_t b = bucket(k);
+        if (head[b] == NIL) {
+            bits[b / 64] |= 1ull << (b % 64);
+            summary[b / 4096] |= 1ull << (b / 64 % 64);
+        }
+        items.push(head[b], x);
+        finite++;
+    }
+
+    void unlink(handle x) {
+        Key k = items.item[x].key;
+        if (k == INF) {
+            items.unlink(infinite, x);
+        } else {
+            std::uint64_t b = bucket(k);
+            items.unlink(head[b], x);
+            if (head[b] == NIL) clearBit(b);
+            finite--;
+        }
+    }
+
+    void clearBit(std::uint64_t b) {
+        if ((bits[b / 64] &= ~(1ull << (b % 64))) == 0) summary[b / 4096] &= ~(1ull << (b / 64 % 64));
+    }
+
+    // first non-empty bucket >= b, or width if there is none
+    std::uint64_t nextOccupied(std::uint64_t b) const {
+        std::uint64_t w = b / 64;
+        std::uint64_t word = bits[w] & (~0ull << (b % 64));
+        if (word) return w * 64 + __builtin_ctzll(word);
+        // the rest of w's summary word, then whole summary words
+        std::uint64_t s = (w + 1) / 64;
+        if (s >= summary.size()) return width;
+        std::uint64_t sword = summary[s] & (~0ull << ((w + 1) % 64));
+        while (sword == 0) {
+            if (++s == summary.size()) return width;
+            sword = summary[s];
+        }
+        w = s * 64 + __builtin_ctzll(sword);
+        return w * 64 + __builtin_ctzll(bits[w]);
+    }
+};
+
+template <class Key, class Payload>
+class RadixHeap {
+    static_assert(std::is_integral<Key>::value, "RadixHeap needs integer keys");
+
+public:
+    using handle = std::uint32_t;
+
+    struct Entry {
+        Key key;
+        Payload payload;
+    };
+
+    RadixHeap() { std::fill(head, head + BUCKETS, NIL); }
+
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+    const Key& key(handle x) const { return items.item[x].key; }
+    const Payload& payload(handle x) const { return items.payload[x]; }
+    void reserve(std::size_t n) {
+        items.reserve(n);
+        where.reserve(n);
+    }
+
+    handle insert(const Key& k, Payload p) {
+        assert(!(k < last) && "RadixHeap keys must not go below the last minimum");
+        handle x = items.create(k, std::move(p));
+        if (where.size() <= x) where.resize(x + 1);
+        link(x);
+        count++;
+        return x;
+    }
+
+    // a k that is not smaller than the current key is ignored
+    void decrease_key(handle x, const Key& k) {
+        if (!(k < items.item[x].key)) return;
+        assert(!(k < last) && "RadixHeap keys must not go below the last minimum");
+        items.unlink(head[where[x]], x);
+        items.item[x].key = k;
+        link(x);
+    }
+
+    Entry extract_min() {
+        if (head[0] == NIL) {
+            int b = 1;
+            while (head[b] == NIL) b++;
+            // the new minimum, then everything in b moves down
+            handle x = head[b];
+            Key m = items.item[x].key;
+            for (handle y = items.item[x].next; y != NIL; y = items.item[y].next)
+                if (items.item[y].key < m) m = items.item[y].key;
+            last = m;
+            while (head[b] != NIL) {
+                handle y = head[b];
+                items.unlink(head[b], y);
+                link(y);
+            }
+        }
+        handle x = head[0];
+        items.unlink(head[0], x);
+        items.release(x);
+        count--;
+        return Entry{items.item[x].key, std::move(items.payload[x])};
+    }
+
+    void clear() {
+        std::fill(head, head + BUCKETS, NIL);
+        items.clear();
+        where.clear();
+        count = 0;
+        last = 0;
+    }
+
+private:
+    static constexpr int BUCKETS = 65;
+    static constexpr std::uint32_t NIL = bucket_queue_detail::NIL;
+
+    handle head[BUCKETS];
+    std::vector<unsigned char> where;  // bucket of each handle
+    std::size_t count = 0;
+    Key last = 0;  // the last minimum extracted
+    bucket_queue_detail::Items<Key, Payload> items;
+
+    void link(handle x) {
+        std::uint64_t diff = (std::uint64_t)items.item[x].key ^ (std::uint64_t)last;
+        int b = diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+        where[x] = (unsigned char)b;
+        items.push(head[b], x);
+    }
+};
@@ -0,0 +1,213 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "bucket_sort_simd.h"
+#include "thread_pool.h"
+
+// Bucket sort for integers (32 or 64 bit) and floating point values.
+//
+//   1. one pass for min and max (SIMD, bucket_sort_simd.h)
+//   2. a counting pass sizes the k buckets, a prefix sum turns the counts
+//      into offsets, and a second pass scatters every value into its bucket
+//      in a single flat buffer of n values (no per-bucket vectors)
+//   3. every bucket is sorted in place: insertion sort while it is small;
+//      a large one (skewed input piles into a few buckets) is bucket sorted
+//      again over its own, narrower value range, and past two such levels
+//      handed to std::sort, so the worst case is O(n log n), not quadratic
+//
+// A value's bucket is (x - min) * (k / (max - min)), computed in double and
+// clamped to k - 1. That map never decreases as x grows, so the buckets come
+// out in order and concatenating them sorts the array; rounding only moves a
+// value into a neighbouring bucket, never out of order. The indices are
+// computed a block at a time by the SIMD kernel, for the counting and the
+// scatter pass alike.
+// NaNs are not supported; infinities fall back to std::sort.
+//
+// With a ThreadPool the same steps run on every thread: per-thread min/max
+// and histograms over the for_chunks ranges, a prefix sum in (bucket,
+// thread) order that gives each thread its own slice of every bucket, and a
+// per-thread scatter. The buckets are then handed out largest first through
+// a shared counter, so a thread that drew small buckets keeps taking more
+// while another finishes a big one; a bucket too large for one thread
+// (more than n / threads values) is itself sorted with the whole pool first.
+// Each bucket is sorted with the serial code.
+//
+// Both use at most 2^16 buckets per level: past that the scatter touches
+// more cache lines than it saves, and the per-thread histograms stay small.
+
+namespace bucket_sort_detail {
+
+// insertion sort of [first, last) when *(first - 1) is <= every element in
+// it: the scan needs no bounds check
+template <class T>
+void unguardedInsertionSort(T* first, T* last) {
+    for (T* i = first; i < last; i++) {
+        T x = *i;
+        T* j = i;
+        for (; x < j[-1]; j--) *j = j[-1];
+        *j = x;
+    }
+}
+
+template <class T>
+void insertionSort(T* first, T* last) {
+    if (last - first < 2) return;
+    // the minimum goes first and then serves as the sentinel
+    std::iter_swap(first, std::min_element(first, last));
+    unguardedInsertionSort(first + 1, last);
+}
+
+// buckets up to this size get insertion sort; levels of re-bucketing; the
+// most buckets per level (more only spread the scatter over more cache
+// lines); values per call of the bucket index kernel
+const std::size_t SMALL = 32;
+const int MAX_DEPTH = 2;
+const std::size_t MAX_BUCKETS = 1 << 16;
+const std::size_t BLOCK = 512;
+
+// f(i, bucket of a[i]) for i in [from, to)
+template <class T, class F>
+void forEachBucket(const T* a, std::size_t from, std::size_t to, T lo, double scale, std::size_t k, F f) {
+    std::uint32_t idx[BLOCK];
+    for (std::size_t i = from; i < to; i += BLOCK) {
+        std::size_t m = std::min(BLOCK, to - i);
+        bucket_simd::bucketIndex(a + i, m, lo, scale, (std::uint32_t)(k - 1), idx);
+        for (std::size_t j = 0; j < m; j++) f(i + j, idx[j]);
+    }
+}
+
+// the kernels' indices are 32-bit
+inline std::size_t bucketCount(std::size_t n, std::size_t k) {
+    if (k == 0) k = std::min(MAX_BUCKETS, std::max<std::size_t>(1, n / 4));
+    return std::min<std::size_t>(k, (std::size_t)1 << 31);
+}
+
+template <class T>
+void serialSort(T* a, std::size_t n, std::size_t k, int depth) {
+    if (n < 2) return;
+    k = bucketCount(n, k);
+
+    T lo, hi;
+    bucket_simd::minMax(a, n, lo, hi);
+    if (!(lo < hi)) return;  // all equal
+    double range = bucket_simd::offset(hi, lo);
+    if (!std::isfinite(range)) {
+        std::sort(a, a + n);
+        return;
+    }
+    double scale = (double)k / range;
+
+    std::vector<std::size_t> start(k + 1, 0);
+    forEachBucket(a, 0, n, lo, scale, k, [&](std::size_t, std::uint32_t b) { start[b + 1]++; });
+    for (std::size_t b = 0; b < k; b++) start[b + 1] += start[b];
+    std::vector<T> out(n);
+    {
+        std::vector<std::size_t> fill(start.begin(), start.end() - 1);
+        forEachBucket(a, 0, n, lo, scale, k, [&](std::size_t i, std::uint32_t b) { out[fill[b]++] = a[i]; });
+    }
+
+    for (std::size_t b = 0; b < k; b++) {
+        T* first = out.data() + start[b];
+        T* last = out.data() + start[b + 1];
+        std::size_t size = last - first;
+        if (size > SMALL && depth < MAX_DEPTH) serialSort(first, size, 0, depth + 1);
+        else if (size > SMALL) std::sort(first, last);
+        else if (b == 0) insertionSort(first, last);
+        else unguardedInsertionSort(first, last);  // bucket 0 holds min, and every earlier value is <= these
+    }
+    std::copy(out.begin(), out.end(), a);
+}
+
+template <class T>
+void parallelSort(T* a, std::size_t n, std::size_t k, ThreadPool& pool, int depth) {
+    unsigned threads = pool.size();
+    if (n < 2) return;
+    k = bucketCount(n, k);
+
+    std::vector<T> tlo(threads, a[0]), thi(threads, a[0]);
+    pool.for_chunks(n, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        if (hi > lo) bucket_simd::minMax(a + lo, hi - lo, tlo[t], thi[t]);
+    });
+    T lo = *std::min_element(tlo.begin(), tlo.end()), hi = *std::max_element(thi.begin(), thi.end());
+    if (!(lo < hi)) return;  // all equal
+    double range = bucket_simd::offset(hi, lo);
+    if (!std::isfinite(range)) {
+        std::sort(a, a + n);
+        return;
+    }
+    double scale = (double)k / range;
+
+    // count[t * k + b]: values of chunk t in bucket b, then where they go
+    std::vector<std::size_t> count((std::size_t)threads * k), start(k + 1);
+    pool.for_chunks(n, [&](unsigned t, std::size_t from, std::size_t to) {
+        std::size_t* c = &count[(std::size_t)t * k];
+        std::fill(c, c + k, 0);
+        forEachBucket(a, from, to, lo, scale, k, [&](std::size_t, std::uint32_t b) { c[b]++; });
+    });
+    std::size_t sum = 0;
+    for (std::size_t b = 0; b < k; b++) {
+        start[b] = sum;
+        for (unsigned t = 0; t < threads; t++) {
+            std::size_t x = count[(std::size_t)t * k + b];
+            count[(std::size_t)t * k + b] = sum;
+            sum += x;
+        }
+    }
+    start[k] = n;
+    std::vector<T> out(n);
+    pool.for_chunks(n, [&](unsigned t, std::size_t from, std::size_t to) {
+        std::size_t* c = &count[(std::size_t)t * k];
+        forEachBucket(a, from, to, lo, scale, k, [&](std::size_t i, std::uint32_t b) { out[c[b]++] = a[i]; });
+    });
+
+    // buckets worth a whole pool go first, one at a time; the rest largest
+    // first from a shared counter
+    std::vector<std::size_t> order;
+    for (std::size_t b = 0; b < k; b++) {
+        std::size_t size = start[b + 1] - start[b];
+        if (size > n / threads && size > MAX_BUCKETS && depth < MAX_DEPTH) {
+            parallelSort(out.data() + start[b], size, 0, pool, depth + 1);
+            pool.for_chunks(size, [&](unsigned, std::size_t lo, std::size_t hi) {
+                std::copy(out.begin() + start[b] + lo, out.begin() + start[b] + hi, a + start[b] + lo);
+            });
+        } else if (size > 0) {
+            order.push_back(b);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return start[x + 1] - start[x] > start[y + 1] - start[y];
+    });
+    std::atomic<std::size_t> next(0);
+    pool.run([&](unsigned) {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < order.size();) {
+            std::size_t b = order[i];
+            T* first = out.data() + start[b];
+            T* last = out.data() + start[b + 1];
+            // guarded: the neighbouring buckets belong to other threads
+            if ((std::size_t)(last - first) > SMALL) serialSort(first, last - first, 0, depth + 1);
+            else insertionSort(first, last);
+            std::copy(first, last, a + start[b]);
+        }
+    });
+}
+
+}  // namespace bucket_sort_detail
+
+// Sorts a[0, n) using k buckets (0: n / 4, at most 2^16; never more than
+// 2^31) and a buffer of n values; pool == nullptr (or a pool of one) runs serially.
+template <class T>
+void bucketSort(T* a, std::size_t n, std::size_t k = 0, ThreadPool* pool = nullptr) {
+    static_assert(std::is_arithmetic<T>::value, "bucketSort sorts integers or floating point values");
+    if (pool && pool->size() > 1) bucket_sort_detail::parallelSort(a, n, k, *pool, 0);
+    else bucket_sort_detail::serialSort(a, n, k, 0);
+}
+
+template <class T>
+void bucketSort(std::vector<T>& a, std::size_t k = 0, ThreadPool* pool = nullptr) {
+    bucketSort(a.data(), a.size(), k, pool);
+}
@@ -0,0 +1,364 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define BUCKET_SORT_X86 1
+#endif
+
+// The two per-element loops of bucket sort's distribution phase, for SSE4.2
+// and AVX2 with a scalar fallback, picked at runtime from the CPU:
+//
+//   minMax(a, n, lo, hi)                       one fused pass for both
+//   bucketIndex(a, n, lo, scale, last, idx)    idx[i] = min((x - lo) * scale, last)
+//
+// scale is k / (max - min), so the index costs a multiply, not a divide.
+// The vector kernels do exactly the scalar arithmetic (x - lo as a double,
+// times scale, truncated, clamped), so any level gives the same buckets.
+// int, long long, float and double are vectorized (long long via the exact
+// two-halves uint64 -> double conversion, as AVX2 has no such instruction);
+// other types use the scalar loops. The x86 kernels are compiled with
+// target attributes, so no -mavx2 is needed and the binary still runs on
+// CPUs without AVX2.
+
+namespace bucket_simd {
+
+enum class Level { Scalar, SSE42, AVX2 };
+
+inline Level detectLevel() {
+#ifdef BUCKET_SORT_X86
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return Level::SSE42;
+#endif
+    return Level::Scalar;
+}
+
+// the level in use; benchmarks may lower it to compare the kernels
+inline Level& level() {
+    static Level l = detectLevel();
+    return l;
+}
+
+inline const char* levelName(Level l) {
+    return l == Level::AVX2 ? "avx2" : l == Level::SSE42 ? "sse4.2" : "scalar";
+}
+
+// offset of x from lo as a double, exact for the ranges the bucket map needs
+template <class T>
+double offset(T x, T lo) {
+    if (std::is_integral<T>::value) return (double)((std::uint64_t)x - (std::uint64_t)lo);
+    return (double)x - (double)lo;
+}
+
+template <class T>
+void scalarMinMax(const T* a, std::size_t n, T& lo, T& hi) {
+    T mn = a[0], mx = a[0];
+    for (std::size_t i = 1; i < n; i++) {
+        mn = std::min(mn, a[i]);
+        mx = std::max(mx, a[i]);
+    }
+    lo = mn;
+    hi = mx;
+}
+
+template <class T>
+void scalarBucketIndex(const T* a, std::size_t n, T lo, double scale, std::uint32_t last, std::uint32_t* idx) {
+    for (std::size_t i = 0; i < n; i++)
+        idx[i] = (std::uint32_t)std::min<std::uint64_t>((std::uint64_t)(offset(a[i], lo) * scale), last);
+}
+
+// everything but the vectorized types
+template <class T>
+void minMax(const T* a, std::size_t n, T& lo, T& hi) {
+    scalarMinMax(a, n, lo, hi);
+}
+
+template <class T>
+void bucketIndex(const T* a, std::size_t n, T lo, double scale, std::uint32_t last, std::uint32_t* idx) {
+    scalarBucketIndex(a, n, lo, scale, last, idx);
+}
+
+#ifdef BUCKET_SORT_X86
+
+namespace kernels {
+
+// ---- min / max ----
+// Each kernel folds whole vectors into running min and max vectors, reduces
+// them, and finishes the tail with scalar code.
+
+template <class T>
+void finish(const T* a, std::size_t i, std::size_t n, T& lo, T& hi) {
+    for (; i < n; i++) {
+        lo = std::min(lo, a[i]);
+        hi = std::max(hi, a[i]);
+    }
+}
+
+// the lanes, stored by the kernel (vectors are not passed by value into
+// code compiled without AVX)
+template <class T>
+void reduce(const T* l, const T* h, int lanes, T& lo, T& hi) {
+    lo = *std::min_element(l, l + lanes);
+    hi = *std::max_element(h, h + lanes);
+}
+
+__attribute__((target("avx2"))) inline void minMaxAVX2(const int* a, std::size_t n, int& lo, int& hi) {
+    __m256i vlo = _mm256_set1_epi32(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        vlo = _mm256_min_epi32(vlo, x);
+        vhi = _mm256_max_epi32(vhi, x);
+    }
+    alignas(32) int l[8], h[8];
+    _mm256_storeu_si256((__m256i*)l, vlo);
+    _mm256_storeu_si256((__m256i*)h, vhi);
+    reduce(l, h, 8, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("avx2"))) inline void minMaxAVX2(const long long* a, std::size_t n, long long& lo,
+                                                       long long& hi) {
+    __m256i vlo = _mm256_set1_epi64x(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        vlo = _mm256_blendv_epi8(vlo, x, _mm256_cmpgt_epi64(vlo, x));
+        vhi = _mm256_blendv_epi8(vhi, x, _mm256_cmpgt_epi64(x, vhi));
+    }
+    alignas(32) long long l[4], h[4];
+    _mm256_storeu_si256((__m256i*)l, vlo);
+    _mm256_storeu_si256((__m256i*)h, vhi);
+    reduce(l, h, 4, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("avx2"))) inline void minMaxAVX2(const float* a, std::size_t n, float& lo, float& hi) {
+    __m256 vlo = _mm256_set1_ps(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(a + i);
+        vlo = _mm256_min_ps(vlo, x);
+        vhi = _mm256_max_ps(vhi, x);
+    }
+    alignas(32) float l[8], h[8];
+    _mm256_storeu_ps(l, vlo);
+    _mm256_storeu_ps(h, vhi);
+    reduce(l, h, 8, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("avx2"))) inline void minMaxAVX2(const double* a, std::size_t n, double& lo, double& hi) {
+    __m256d vlo = _mm256_set1_pd(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        vlo = _mm256_min_pd(vlo, x);
+        vhi = _mm256_max_pd(vhi, x);
+    }
+    alignas(32) double l[4], h[4];
+    _mm256_storeu_pd(l, vlo);
+    _mm256_storeu_pd(h, vhi);
+    reduce(l, h, 4, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("sse4.2"))) inline void minMaxSSE(const int* a, std::size_t n, int& lo, int& hi) {
+    __m128i vlo = _mm_set1_epi32(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        vlo = _mm_min_epi32(vlo, x);
+        vhi = _mm_max_epi32(vhi, x);
+    }
+    alignas(32) int l[4], h[4];
+    _mm_storeu_si128((__m128i*)l, vlo);
+    _mm_storeu_si128((__m128i*)h, vhi);
+    reduce(l, h, 4, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("sse4.2"))) inline void minMaxSSE(const long long* a, std::size_t n, long long& lo,
+                                                        long long& hi) {
+    __m128i vlo = _mm_set1_epi64x(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        vlo = _mm_blendv_epi8(vlo, x, _mm_cmpgt_epi64(vlo, x));
+        vhi = _mm_blendv_epi8(vhi, x, _mm_cmpgt_epi64(x, vhi));
+    }
+    alignas(32) long long l[2], h[2];
+    _mm_storeu_si128((__m128i*)l, vlo);
+    _mm_storeu_si128((__m128i*)h, vhi);
+    reduce(l, h, 2, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("sse4.2"))) inline void minMaxSSE(const float* a, std::size_t n, float& lo, float& hi) {
+    __m128 vlo = _mm_set1_ps(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(a + i);
+        vlo = _mm_min_ps(vlo, x);
+        vhi = _mm_max_ps(vhi, x);
+    }
+    alignas(32) float l[4], h[4];
+    _mm_storeu_ps(l, vlo);
+    _mm_storeu_ps(h, vhi);
+    reduce(l, h, 4, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+__attribute__((target("sse4.2"))) inline void minMaxSSE(const double* a, std::size_t n, double& lo, double& hi) {
+    __m128d vlo = _mm_set1_pd(a[0]), vhi = vlo;
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(a + i);
+        vlo = _mm_min_pd(vlo, x);
+        vhi = _mm_max_pd(vhi, x);
+    }
+    alignas(32) double l[2], h[2];
+    _mm_storeu_pd(l, vlo);
+    _mm_storeu_pd(h, vhi);
+    reduce(l, h, 2, lo, hi);
+    finish(a, i, n, lo, hi);
+}
+
+// ---- bucket index ----
+// Four (AVX2) or two (SSE) offsets at a time as doubles. Clamping to last
+// before truncating gives the same index as truncating first, and keeps the
+// value in the range of the int32 conversion (last < 2^31).
+
+// x - lo for four int64 lanes, converted to double as the scalar
+// (double)(uint64) would: the high and low 32 bits go through the
+// 2^84 / 2^52 exponent trick separately and meet in one rounded add
+__attribute__((target("avx2"))) inline __m256d offsetAVX2(__m256i d) {
+    const __m256i hiMagic = _mm256_set1_epi64x(0x4530000000000000ll);  // 2^84
+    const __m256i loMagic = _mm256_set1_epi64x(0x4330000000000000ll);  // 2^52
+    const __m256d both = _mm256_set1_pd(19342813118337666422669312.0);  // 2^84 + 2^52
+    __m256i lo32 = _mm256_blend_epi32(loMagic, d, 0x55);
+    __m256i hi32 = _mm256_or_si256(_mm256_srli_epi64(d, 32), hiMagic);
+    __m256d h = _mm256_sub_pd(_mm256_castsi256_pd(hi32), both);
+    return _mm256_add_pd(h, _mm256_castsi256_pd(lo32));
+}
+
+__attribute__((target("avx2"))) inline void storeIndex(__m256d off, __m256d scale, __m256d last,
+                                                       std::uint32_t* idx) {
+    __m256d b = _mm256_min_pd(_mm256_mul_pd(off, scale), last);
+    _mm_storeu_si128((__m128i*)idx, _mm256_cvttpd_epi32(b));
+}
+
+__attribute__((target("avx2"))) inline void bucketIndexAVX2(const int* a, std::size_t n, int lo, double scale,
+                                                            std::uint32_t last, std::uint32_t* idx) {
+    __m256d vs = _mm256_set1_pd(scale), vl = _mm256_set1_pd(last), vlo = _mm256_set1_pd(lo);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(a + i)));
+        storeIndex(_mm256_sub_pd(x, vlo), vs, vl, idx + i);
+    }
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+__attribute__((target("avx2"))) inline void bucketIndexAVX2(const long long* a, std::size_t n, long long lo,
+                                                            double scale, std::uint32_t last, std::uint32_t* idx) {
+    __m256d vs = _mm256_set1_pd(scale), vl = _mm256_set1_pd(last);
+    __m256i vlo = _mm256_set1_epi64x(lo);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i*)(a + i)), vlo);
+        storeIndex(offsetAVX2(d), vs, vl, idx + i);
+    }
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+__attribute__((target("avx2"))) inline void bucketIndexAVX2(const float* a, std::size_t n, float lo, double scale,
+                                                            std::uint32_t last, std::uint32_t* idx) {
+    __m256d vs = _mm256_set1_pd(scale), vl = _mm256_set1_pd(last), vlo = _mm256_set1_pd(lo);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(a + i));
+        storeIndex(_mm256_sub_pd(x, vlo), vs, vl, idx + i);
+    }
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+__attribute__((target("avx2"))) inline void bucketIndexAVX2(const double* a, std::size_t n, double lo,
+                                                            double scale, std::uint32_t last, std::uint32_t* idx) {
+    __m256d vs = _mm256_set1_pd(scale), vl = _mm256_set1_pd(last), vlo = _mm256_set1_pd(lo);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) storeIndex(_mm256_sub_pd(_mm256_loadu_pd(a + i), vlo), vs, vl, idx + i);
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+__attribute__((target("sse4.2"))) inline void storeIndex(__m128d off, __m128d scale, __m128d last,
+                                                         std::uint32_t* idx) {
+    __m128d b = _mm_min_pd(_mm_mul_pd(off, scale), last);
+    _mm_storel_epi64((__m128i*)idx, _mm_cvttpd_epi32(b));
+}
+
+__attribute__((target("sse4.2"))) inline void bucketIndexSSE(const int* a, std::size_t n, int lo, double scale,
+                                                             std::uint32_t last, std::uint32_t* idx) {
+    __m128d vs = _mm_set1_pd(scale), vl = _mm_set1_pd(last), vlo = _mm_set1_pd(lo);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)(a + i)));
+        storeIndex(_mm_sub_pd(x, vlo), vs, vl, idx + i);
+    }
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+__attribute__((target("sse4.2"))) inline void bucketIndexSSE(const float* a, std::size_t n, float lo, double scale,
+                                                             std::uint32_t last, std::uint32_t* idx) {
+    __m128d vs = _mm_set1_pd(scale), vl = _mm_set1_pd(last), vlo = _mm_set1_pd(lo);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(a + i))));
+        storeIndex(_mm_sub_pd(x, vlo), vs, vl, idx + i);
+    }
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+__attribute__((target("sse4.2"))) inline void bucketIndexSSE(const double* a, std::size_t n, double lo,
+                                                             double scale, std::uint32_t last, std::uint32_t* idx) {
+    __m128d vs = _mm_set1_pd(scale), vl = _mm_set1_pd(last), vlo = _mm_set1_pd(lo);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) storeIndex(_mm_sub_pd(_mm_loadu_pd(a + i), vlo), vs, vl, idx + i);
+    scalarBucketIndex(a + i, n - i, lo, scale, last, idx + i);
+}
+
+// two lanes of the uint64 trick buy nothing over the scalar conversion
+inline void bucketIndexSSE(const long long* a, std::size_t n, long long lo, double scale, std::uint32_t last,
+                           std::uint32_t* idx) {
+    scalarBucketIndex(a, n, lo, scale, last, idx);
+}
+
+}  // namespace kernels
+
+#define BUCKET_SIMD_DISPATCH(T)                                                                          \
+    inline void minMax(const T* a, std::size_t n, T& lo, T& hi) {                                       \
+        switch (level()) {                                                                               \
+        case Level::AVX2: kernels::minMaxAVX2(a, n, lo, hi); return;                                     \
+        case Level::SSE42: kernels::minMaxSSE(a, n, lo, hi); return;                                     \
+        default: scalarMinMax(a, n, lo, hi);                                                             \
+        }                                                                                                \
+    }                                                                                                    \
+    inline void bucketIndex(const T* a, std::size_t n, T lo, double scale, std::uint32_t last,          \
+                            std::uint32_t* idx) {                                                        \
+        switch (level()) {                                                                               \
+        case Level::AVX2: kernels::bucketIndexAVX2(a, n, lo, scale, last, idx); return;                  \
+        case Level::SSE42: kernels::bucketIndexSSE(a, n, lo, scale, last, idx); return;                  \
+        default: scalarBucketIndex(a, n, lo, scale, last, idx);                                          \
+        }                                                                                                \
+    }
+
+BUCKET_SIMD_DISPATCH(int)
+BUCKET_SIMD_DISPATCH(long long)
+BUCKET_SIMD_DISPATCH(float)
+BUCKET_SIMD_DISPATCH(double)
+#undef BUCKET_SIMD_DISPATCH
+
+#endif  // BUCKET_SORT_X86
+
+}  // namespace bucket_simd
@@ -0,0 +1,376 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "mst_stats.h"
+
+// Compact Fibonacci heap: same operations as FibHeap (fib_heap.h), but nodes
+// live in one pool addressed by 32-bit indices instead of pointers.
+//
+// The pool is split by temperature. Everything consolidate() and the cut
+// paths touch (key, four links, degree, mark) sits in one `Hot` record -
+// 32 bytes for 8-byte keys instead of the 48-64 byte pointer node - and
+// the payload lives in a separate array that is only read on extract_min.
+// Because links are indices the pool can grow by plain vector reallocation.
+// -DMST_STATS instruments it like FibHeap, under compact_fib (mst_stats.h).
+template <class Key, class Payload>
+class CompactFibPool {
+public:
+    using index = std::uint32_t;
+    static constexpr index NIL = UINT32_MAX;
+
+    struct Hot {
+        Key key;
+        index left, right, parent, child;
+        std::uint8_t degree;
+        bool mark;
+    };
+
+    struct Stats {
+        std::size_t created = 0;
+        std::size_t recycled = 0;
+        std::size_t live = 0;
+        std::size_t bytes_reserved = 0;
+
+        friend std::ostream& operator<<(std::ostream& os, const Stats& s) {
+            return os << "nodes created " << s.created << " (recycled " << s.recycled << "), live "
+                      << s.live << ", bytes reserved " << s.bytes_reserved;
+        }
+    };
+
+    std::vector<Hot> hot;
+    std::vector<Payload> cold;
+
+    void reserve(std::size_t count) {
+        hot.reserve(hot.size() + count);
+        cold.reserve(cold.size() + count);
+    }
+
+    index create(const Key& k, Payload p) {
+        index i;
+        ++st.created;
+        ++st.live;
+        if (free_head != NIL) {
+            i = free_head;
+            free_head = hot[i].right;
+            hot[i] = Hot{k, i, i, NIL, NIL, 0, false};
+            cold[i] = std::move(p);
+            ++st.recycled;
+            return i;
+        }
+        assert(hot.size() < NIL);
+        i = (index)hot.size();
+        hot.push_back(Hot{k, i, i, NIL, NIL, 0, false});
+        cold.push_back(std::move(p));
+        return i;
+    }
+
+    void destroy(index i) {
+        hot[i].right = free_head;
+        free_head = i;
+        --st.live;
+    }
+
+    // drop every node at once, keeping the capacity
+    void reset() {
+        hot.clear();
+        cold.clear();
+        free_head = NIL;
+        st.live = 0;
+    }
+
+    Stats stats() const {
+        Stats s = st;
+        s.bytes_reserved = hot.capacity() * sizeof(Hot) + cold.capacity() * sizeof(Payload);
+        return s;
+    }
+
+private:
+    index free_head = NIL;
+    Stats st;
+};
+
+template <class Key, class Payload, class Compare = std::less<Key>>
+class CompactFibHeap {
+public:
+    using Pool = CompactFibPool<Key, Payload>;
+    using handle = typename Pool::index;
+    static constexpr handle NIL = Pool::NIL;
+
+    struct Entry {
+        Key key;
+        Payload payload;
+    };
+
+    explicit CompactFibHeap(Compare cmp = Compare())
+        : minimum(NIL), n(0), less(cmp), owned_pool(new Pool()), pool(owned_pool.get()) {}
+    // heaps that will be melded must share one pool (indices are pool-relative)
+    explicit CompactFibHeap(Pool& shared, Compare cmp = Compare())
+        : minimum(NIL), n(0), less(cmp), pool(&shared) {}
+
+    // nothing to free on destruction: nodes of a shared pool come back on its
+    // reset(), a private pool goes away with the heap
+    CompactFibHeap(const CompactFibHeap&) = delete;
+    CompactFibHeap& operator=(const CompactFibHeap&) = delete;
+    CompactFibHeap(CompactFibHeap&& o) noexcept
+        : minimum(o.minimum), n(o.n), less(o.less), owned_pool(std::move(o.owned_pool)), pool(o.pool) {
+        o.minimum = NIL;
+        o.n = 0;
+    }
+    CompactFibHeap& operator=(CompactFibHeap&& o) noexcept {
+        if (this != &o) {
+            clear();
+            minimum = o.minimum;
+            n = o.n;
+            less = o.less;
+            owned_pool = std::move(o.owned_pool);
+            pool = o.pool;
+            o.minimum = NIL;
+            o.n = 0;
+        }
+        return *this;
+    }
+
+    bool empty() const { return minimum == NIL; }
+    std::size_t size() const { return n; }
+    handle get_min() const { return minimum; }
+    const Key& key(handle x) const { return pool->hot[x].key; }
+    const Payload& payload(handle x) const { return pool->cold[x]; }
+    void reserve(std::size_t count) { pool->reserve(count); }
+    const Pool* get_pool() const { return pool; }
+
+    handle insert(const Key& k, Payload p) {
+        MST_STAT_TIME(compact_fib.insert);
+        handle x = pool->create(k, std::move(p));
+        add_root(x);
+        if (less(k, hot(minimum).key)) minimum = x;
+        ++n;
+        return x;
+    }
+
+    void meld(CompactFibHeap& other) {
+        if (this == &other || other.minimum == NIL) return;
+        MST_STAT_TIME(compact_fib.meld);
+        assert(pool == other.pool);
+        if (minimum == NIL) {
+            minimum = other.minimum;
+        } else {
+            handle a = hot(minimum).left;
+            handle b = hot(other.minimum).left;
+            hot(a).right = other.minimum;
+            hot(other.minimum).left = a;
+            hot(b).right = minimum;
+            hot(minimum).left = b;
+            if (less(hot(other.minimum).key, hot(minimum).key)) minimum = other.minimum;
+        }
+        n += other.n;
+        other.minimum = NIL;
+        other.n = 0;
+    }
+
+    Entry extract_min() {
+        MST_STAT_TIME(compact_fib.extract_min);
+        handle z = minimum;
+        // splice z's child list next to z; consolidate() clears the parents
+        if (hot(z).child != NIL) {
+            handle first = hot(z).child;
+            handle last = hot(first).left;
+            Hot& hz = hot(z);
+            hot(hz.left).right = first;
+            hot(first).left = hz.left;
+            hot(last).right = z;
+            hz.left = last;
+            hz.child = NIL;
+        }
+        if (hot(z).right == z) {
+            minimum = NIL;
+        } else {
+            minimum = hot(z).right;
+            remove_from_list(z);
+            consolidate();
+        }
+        --n;
+        Entry e{hot(z).key, std::move(pool->cold[z])};
+        pool->destroy(z);
+        return e;
+    }
+
+    // lowers x's key to k; a k that is not smaller than the current key is ignored
+    void decrease_key(handle x, const Key& k) {
+        MST_STAT_TIME(compact_fib.decrease_key);
+        if (less(hot(x).key, k)) return;
+        hot(x).key = k;
+        handle y = hot(x).parent;
+        if (y != NIL && less(k, hot(y).key)) {
+            cut(x, y);
+            cascading_cut(y);
+        }
+        if (less(k, hot(minimum).key)) minimum = x;
+    }
+
+    void erase(handle x) {
+        MST_STAT_TIME(compact_fib.erase);
+        handle y = hot(x).parent;
+        if (y != NIL) {
+            cut(x, y);
+            cascading_cut(y);
+        }
+        minimum = x;
+        extract_min();
+    }
+
+    void clear() {
+        if (minimum == NIL) return;
+        if (pool == owned_pool.get()) {
+            pool->reset();
+        } else {
+            std::vector<handle> stack{minimum};
+            while (!stack.empty()) {
+                handle start = stack.back();
+                stack.pop_back();
+                handle cur = start;
+                do {
+                    handle next = hot(cur).right;
+                    if (hot(cur).child != NIL) stack.push_back(hot(cur).child);
+                    pool->destroy(cur);
+                    cur = next;
+                } while (cur != start);
+            }
+        }
+        minimum = NIL;
+        n = 0;
+    }
+
+private:
+    using Hot = typename Pool::Hot;
+
+    handle minimum;
+    std::size_t n;
+    Compare less;
+    std::unique_ptr<Pool> owned_pool;
+    Pool* pool;
+
+    Hot& hot(handle x) { return pool->hot[x]; }
+
+    void add_root(handle x) {
+        if (minimum == NIL) {
+            hot(x).left = hot(x).right = x;
+            minimum = x;
+        } else {
+            Hot& m = hot(minimum);
+            hot(x).left = m.left;
+            hot(x).right = minimum;
+            hot(m.left).right = x;
+            m.left = x;
+        }
+    }
+
+    void remove_from_list(handle x) {
+        Hot& h = hot(x);
+        hot(h.left).right = h.right;
+        hot(h.right).left = h.left;
+        h.left = h.right = x;
+    }
+
+    // make y a child of x; y must already be detached
+    void link(handle y, handle x) {
+        Hot& hx = hot(x);
+        if (hx.child == NIL) {
+            hx.child = y;
+        } else {
+            Hot& c = hot(hx.child);
+            hot(y).left = c.left;
+            hot(y).right = hx.child;
+            hot(c.left).right = y;
+            c.left = y;
+        }
+        hot(y).parent = x;
+        hot(y).mark = false;
+        hx.degree += 1;
+        MST_STAT_COUNT(compact_fib.links);
+    }
+
+    // per-thread scratch for consolidate(), see FibHeap::degree_table
+    static std::vector<handle>& degree_table(std::size_t count) {
+        int bound = (int)(std::log2((double)count + 1) * 1.4404200904125564) + 2;
+        static thread_local std::vector<handle> table;
+        if ((int)table.size() < bound) table.resize(bound, NIL);
+        return table;
+    }
+
+    void consolidate() {
+        std::vector<handle>& A = degree_table(n);
+        int top = -1;
+        std::size_t roots = 0;
+
+        handle w = minimum;
+        hot(hot(w).left).right = NIL;
+        while (w != NIL) {
+            Hot& hw = hot(w);
+            handle next = hw.right;
+            hw.left = hw.right = w;
+            hw.parent = NIL;
+            hw.mark = false;
+            handle x = w;
+            int d = hw.degree;
+            while (A[d] != NIL) {
+                handle y = A[d];
+                A[d] = NIL;
+                if (less(hot(y).key, hot(x).key)) std::swap(x, y);
+                link(y, x);
+                ++d;
+            }
+            assert(d < (int)A.size());
+            A[d] = x;
+            if (d > top) top = d;
+            w = next;
+            ++roots;
+        }
+        MST_STAT_SAMPLE(compact_fib.root_list, roots);
+        MST_STAT_SAMPLE(compact_fib.max_degree, top);
+
+        minimum = NIL;
+        for (int d = 0; d <= top; ++d) {
+            handle x = A[d];
+            if (x == NIL) continue;
+            A[d] = NIL;
+            add_root(x);
+            if (less(hot(x).key, hot(minimum).key)) minimum = x;
+        }
+    }
+
+    // x is a child of y: move x to the root list
+    void cut(handle x, handle y) {
+        Hot& hy = hot(y);
+        if (hot(x).right == x) {
+            hy.child = NIL;
+        } else {
+            if (hy.child == x) hy.child = hot(x).right;
+            remove_from_list(x);
+        }
+        hy.degree -= 1;
+        hot(x).parent = NIL;
+        hot(x).mark = false;
+        MST_STAT_COUNT(compact_fib.cuts);
+        add_root(x);
+    }
+
+    void cascading_cut(handle y) {
+        for (handle z = hot(y).parent; z != NIL; y = z, z = hot(y).parent) {
+            if (!hot(y).mark) {
+                hot(y).mark = true;
+                MST_STAT_COUNT(compact_fib.marks);
+                return;
+            }
+            MST_STAT_COUNT(compact_fib.cascading_cuts);
+            cut(y, z);
+        }
+    }
+};
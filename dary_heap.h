@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Indexed d-ary min-heap with the same interface as FibHeap (insert /
+// decrease_key / extract_min) so it can stand in for it in Prim.
+//
+// The heap array holds (key, id) pairs, so sift loops compare keys without
+// leaving the array; pos[id] tracks where each id sits for decrease_key.
+// D = 4 usually wins: half the depth of a binary heap and the four
+// children of a node share a cache line for 8-byte keys.
+template <class Key, class Payload, unsigned D = 4, class Compare = std::less<Key>>
+class DaryHeap {
+    static_assert(D >= 2, "DaryHeap needs at least two children per node");
+
+public:
+    using handle = std::uint32_t;
+
+    struct Entry {
+        Key key;
+        Payload payload;
+    };
+
+    explicit DaryHeap(Compare cmp = Compare()) : less(cmp) {}
+
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+    const Key& key(handle x) const { return heap[pos[x]].key; }
+    const Payload& payload(handle x) const { return payloads[x]; }
+
+    void reserve(std::size_t count) {
+        heap.reserve(count);
+        pos.reserve(count);
+        payloads.reserve(count);
+    }
+
+    handle insert(const Key& k, Payload p) {
+        handle x;
+        if (!free_ids.empty()) {
+            x = free_ids.back();
+            free_ids.pop_back();
+            payloads[x] = std::move(p);
+        } else {
+            x = (handle)pos.size();
+            pos.push_back(0);
+            payloads.push_back(std::move(p));
+        }
+        heap.push_back({k, x});
+        sift_up(heap.size() - 1);
+        return x;
+    }
+
+    // a k that is not smaller than the current key is ignored
+    void decrease_key(handle x, const Key& k) {
+        std::size_t i = pos[x];
+        if (less(heap[i].key, k)) return;
+        heap[i].key = k;
+        sift_up(i);
+    }
+
+    Entry extract_min() {
+        handle x = heap[0].id;
+        Entry e{std::move(heap[0].key), std::move(payloads[x])};
+        free_ids.push_back(x);
+        Slot last = std::move(heap.back());
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = std::move(last);
+            sift_down(0);
+        }
+        return e;
+    }
+
+    void clear() {
+        heap.clear();
+        pos.clear();
+        payloads.clear();
+        free_ids.clear();
+    }
+
+private:
+    struct Slot {
+        Key key;
+        handle id;
+    };
+
+    std::vector<Slot> heap;
+    std::vector<std::uint32_t> pos;  // by handle
+    std::vector<Payload> payloads;   // by handle
+    std::vector<handle> free_ids;
+    Compare less;
+
+    // hole-based sifts: move the travelling slot once instead of swapping
+    void sift_up(std::size_t i) {
+        Slot s = std::move(heap[i]);
+        while (i > 0) {
+            std::size_t p = (i - 1) / D;
+            if (!less(s.key, heap[p].key)) break;
+            heap[i] = std::move(heap[p]);
+            pos[heap[i].id] = (std::uint32_t)i;
+            i = p;
+        }
+        pos[s.id] = (std::uint32_t)i;
+        heap[i] = std::move(s);
+    }
+
+    void sift_down(std::size_t i) {
+        std::size_t n = heap.size();
+        Slot s = std::move(heap[i]);
+        for (;;) {
+            std::size_t c = i * D + 1;
+            if (c >= n) break;
+            std::size_t end = c + D < n ? c + D : n;
+            std::size_t best = c;
+            for (std::size_t j = c + 1; j < end; ++j)
+                if (less(heap[j].key, heap[best].key)) best = j;
+            if (!less(heap[best].key, s.key)) break;
+            heap[i] = std::move(heap[best]);
+            pos[heap[i].id] = (std::uint32_t)i;
+            i = best;
+        }
+        pos[s.id] = (std::uint32_t)i;
+        heap[i] = std::move(s);
+    }
+};
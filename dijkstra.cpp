@@ -0,0 +1,158 @@
+#include <bits/stdc++.h>
+#include "bucket_queue.h"
+#include "compact_fib_heap.h"
+#include "dary_heap.h"
+#include "dijkstra.h"
+#include "fib_heap.h"
+#include "graph_binary.h"
+#include "output_writer.h"
+#include "pairing_heap.h"
+using namespace std;
+
+// key = tentative distance, payload = the vertex
+using DijkstraHeap = FibHeap<long long, int>;
+
+static void writeDist(BufferedWriter& out, long long d) {
+    if (d == LLONG_MAX) out << "-1";
+    else out << d;
+}
+
+// one query per line: k s1 .. sk  l t1 .. tl  (1-indexed)
+template <class Heap, class... HeapArgs>
+bool runQueries(const DijkstraGraph& g, istream& in, BufferedWriter& out, HeapArgs... heapArgs) {
+    DijkstraEngine<Heap> sp(g, heapArgs...);
+    vector<int> sources, targets;
+    // 1: read, 0: malformed, -1: end of input before the count
+    auto readList = [&](vector<int>& list) {
+        long long k;
+        if (!(in >> k)) return in.eof() ? -1 : 0;
+        if (k < 0 || k > g.n) return 0;
+        list.resize((size_t)k);
+        for (int& v : list) {
+            if (!(in >> v) || v < 1 || v > g.n) return 0;
+            v--;
+        }
+        return 1;
+    };
+    for (;;) {
+        int r = readList(sources);
+        if (r != 1) return r == -1;
+        if (readList(targets) != 1) return false;
+        sp.run(sources, targets);
+        if (targets.empty()) {
+            for (int v = 0; v < g.n; v++) {
+                if (v) out << ' ';
+                writeDist(out, sp.dist(v));
+            }
+        } else {
+            for (size_t i = 0; i < targets.size(); i++) {
+                if (i) out << ' ';
+                writeDist(out, sp.dist(targets[i]));
+            }
+        }
+        out << '\n';
+    }
+}
+
+template <class Heap, class... HeapArgs>
+bool runSource(const DijkstraGraph& g, int source, BufferedWriter& out, HeapArgs... heapArgs) {
+    DijkstraEngine<Heap> sp(g, heapArgs...);
+    sp.run({source});
+    for (int v = 0; v < g.n; v++) {
+        out << v + 1 << ' ';
+        writeDist(out, sp.dist(v));
+        out << '\n';
+    }
+    return true;
+}
+
+// batch mode when queries is set, else all distances from source
+template <class Heap, class... HeapArgs>
+bool run(const DijkstraGraph& g, istream* queries, int source, BufferedWriter& out, HeapArgs... heapArgs) {
+    if (queries) return runQueries<Heap>(g, *queries, out, heapArgs...);
+    return runSource<Heap>(g, source, out, heapArgs...);
+}
+
+// ---- Dijkstra engine (dijkstra.h) on a selectable queue ----
+// --heap=auto|fib|compact|binary|dary4|pairing|dial|radix
+//                                          priority queue; auto (the default)
+//                                          takes Dial's bucket queue when the
+//                                          weights are below 2^20, the radix
+//                                          heap otherwise
+// --source=S                               distances from vertex S (default 1),
+//                                          one "v dist" line per vertex
+// --queries=FILE                           batch mode, one query per line:
+//                                            k s1 .. sk  l t1 .. tl
+//                                          prints the distances from the
+//                                          nearest source to t1 .. tl on one
+//                                          line (l = 0: to every vertex)
+// [input]                                  text edge list or binary graph file
+//                                          (default: text on stdin)
+// Vertices are 1-indexed; unreachable ones print -1. Edges are undirected
+// and their weights must be non-negative.
+int main(int argc, char** argv) {
+    string heap = "auto";
+    const char* input = nullptr;
+    const char* queries = nullptr;
+    int source = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--heap=", 0) == 0) heap = arg.substr(7);
+        else if (arg.rfind("--source=", 0) == 0) source = atoi(arg.c_str() + 9);
+        else if (arg.rfind("--queries=", 0) == 0) queries = argv[i] + 10;
+        else input = argv[i];
+    }
+    LoadedGraph<WeightedEdge<long long>> in;
+    if (!in.load(input, 1, false)) {
+        cerr << (input ? input : "stdin") << ": " << in.error << "\n";
+        return 1;
+    }
+    in.dropEdges();
+    const DijkstraGraph& g = in.g;
+    if (any_of(g.weight, g.weight + g.arcs(), [](long long w) { return w < 0; })) {
+        cerr << "negative edge weight: Dijkstra needs weights >= 0\n";
+        return 1;
+    }
+
+    ifstream qin;
+    if (queries) {
+        qin.open(queries);
+        if (!qin) {
+            cerr << queries << ": cannot open\n";
+            return 1;
+        }
+    } else if (source < 1 || source > g.n) {
+        cerr << "source " << source << " out of range 1.." << g.n << "\n";
+        return 1;
+    }
+    istream* q = queries ? &qin : nullptr;
+
+    // one Dial bucket per key in [d, d + max weight]
+    long long maxWeight = g.arcs() > 0 ? *max_element(g.weight, g.weight + g.arcs()) : 0;
+    uint64_t width = (uint64_t)maxWeight + 1;
+    if (heap == "auto") heap = width <= DIAL_MAX_WIDTH ? "dial" : "radix";
+
+    BufferedWriter out;
+    bool ok;
+    if (heap == "dial") {
+        if (width > DIAL_MAX_WIDTH) {
+            cerr << "dial: weights up to " << maxWeight << " need more than " << DIAL_MAX_WIDTH << " buckets\n";
+            return 1;
+        }
+        ok = run<DialQueue<long long, int>>(g, q, source - 1, out, width);
+    } else if (heap == "radix") ok = run<RadixHeap<long long, int>>(g, q, source - 1, out);
+    else if (heap == "fib") ok = run<DijkstraHeap>(g, q, source - 1, out);
+    else if (heap == "compact") ok = run<CompactFibHeap<long long, int>>(g, q, source - 1, out);
+    else if (heap == "binary") ok = run<DaryHeap<long long, int, 2>>(g, q, source - 1, out);
+    else if (heap == "dary4") ok = run<DaryHeap<long long, int, 4>>(g, q, source - 1, out);
+    else if (heap == "pairing") ok = run<PairingHeap<long long, int>>(g, q, source - 1, out);
+    else {
+        cerr << "unknown heap '" << heap << "'\n";
+        return 1;
+    }
+    if (!ok) {
+        cerr << queries << ": malformed query\n";
+        return 1;
+    }
+    return 0;
+}
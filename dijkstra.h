@@ -0,0 +1,144 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "graph.h"
+
+// Dijkstra's shortest paths on the CsrGraph the MST programs load, templated
+// on the priority queue like primMST (prim.h): FibHeap, CompactFibHeap,
+// DaryHeap and PairingHeap all work, and so do the integer queues of
+// bucket_queue.h (DialQueue, RadixHeap), which take their key range as
+// constructor arguments: the engine passes any extra arguments on to the
+// heap.
+//
+//   DijkstraEngine<FibHeap<long long, int>> sp(g);
+//   sp.run({s});                  // single source, every reachable vertex
+//   sp.run({s1, s2}, {t1, t2});   // nearest source; stop once t1, t2 are settled
+//   sp.dist(t1), sp.path(t1)
+//
+// A vertex is inserted when first reached and decrease_key'd when a shorter
+// path turns up, so the queue only ever holds the frontier, one handle per
+// vertex. Weights must be non-negative.
+//
+// The engine keeps its arrays from run to run and resets only the vertices
+// the previous run reached, so a batch of queries on one loaded graph costs
+// what each search explores, not O(n) per query.
+
+using DijkstraGraph = CsrGraph<long long>;
+
+// empties a heap that may still hold the frontier of an early stop
+template <class Heap>
+auto clearHeap(Heap& H, int) -> decltype(H.clear(), void()) {
+    H.clear();
+}
+template <class Heap>
+void clearHeap(Heap& H, long) {
+    while (!H.empty()) H.extract_min();
+}
+
+template <class Heap>
+class DijkstraEngine {
+public:
+    template <class... HeapArgs>
+    explicit DijkstraEngine(const DijkstraGraph& g, HeapArgs&&... heapArgs)
+        : g(g),
+          H(std::forward<HeapArgs>(heapArgs)...),
+          distance(g.n, LLONG_MAX),
+          parentOf(g.n, -1),
+          state(g.n, UNSEEN),
+          isTarget(g.n, 0),
+          nodes(g.n) {}
+
+    DijkstraEngine(const DijkstraEngine&) = delete;
+    DijkstraEngine& operator=(const DijkstraEngine&) = delete;
+
+    // Distances from the nearest of the sources (0-indexed). With targets,
+    // the search stops as soon as all of them are settled; without, it runs
+    // until every reachable vertex is. Returns the number of settled
+    // vertices.
+    std::size_t run(const std::vector<int>& sources, const std::vector<int>& targets = {}) {
+        reset();
+        int remaining = 0;
+        for (int t : targets) {
+            if (!isTarget[t]) remaining++;
+            isTarget[t] = 1;
+        }
+        for (int s : sources) {
+            if (state[s] != UNSEEN) continue;
+            distance[s] = 0;
+            nodes[s] = H.insert(0, s);
+            state[s] = QUEUED;
+            touched.push_back(s);
+        }
+
+        std::size_t settled = 0;
+        while (!H.empty()) {
+            auto uNode = H.extract_min();
+            int u = uNode.payload;
+            state[u] = DONE;
+            settled++;
+            if (isTarget[u] && --remaining == 0) break;
+
+            long long du = distance[u];
+            for (std::size_t a = g.begin(u); a < g.end(u); a++) {
+                int v = g.target[a];
+                long long d = du + g.weight[a];
+                if (state[v] == DONE || d >= distance[v]) continue;
+                distance[v] = d;
+                parentOf[v] = u;
+                if (state[v] == UNSEEN) {
+                    nodes[v] = H.insert(d, v);
+                    state[v] = QUEUED;
+                    touched.push_back(v);
+                } else {
+                    H.decrease_key(nodes[v], d);
+                }
+            }
+        }
+        clearHeap(H, 0);
+        for (int t : targets) isTarget[t] = 0;
+        return settled;
+    }
+
+    // final distance of v, or LLONG_MAX if the last run did not settle it
+    // (unreachable, or not reached before the search stopped)
+    long long dist(int v) const { return state[v] == DONE ? distance[v] : LLONG_MAX; }
+    bool settled(int v) const { return state[v] == DONE; }
+    // predecessor on a shortest path; -1 for sources and unsettled vertices
+    int parent(int v) const { return state[v] == DONE ? parentOf[v] : -1; }
+
+    // vertices from the source to t, empty if t was not settled
+    std::vector<int> path(int t) const {
+        std::vector<int> p;
+        if (!settled(t)) return p;
+        for (int v = t; v != -1; v = parentOf[v]) p.push_back(v);
+        std::reverse(p.begin(), p.end());
+        return p;
+    }
+
+    // vertices the last run reached (settled or still queued)
+    std::size_t reached() const { return touched.size(); }
+
+    Heap& heap() { return H; }
+
+private:
+    enum : char { UNSEEN, QUEUED, DONE };
+    const DijkstraGraph& g;
+    Heap H;
+    std::vector<long long> distance;
+    std::vector<int> parentOf;
+    std::vector<char> state, isTarget;
+    std::vector<typename Heap::handle> nodes;
+    std::vector<int> touched;
+
+    void reset() {
+        for (int v : touched) {
+            distance[v] = LLONG_MAX;
+            parentOf[v] = -1;
+            state[v] = UNSEEN;
+        }
+        touched.clear();
+    }
+};
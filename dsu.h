@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "mst_stats.h"
+
+// Union-find shared by the MST engines. With -DMST_STATS both kinds record
+// their find path lengths and time find / unite (mst_stats.h).
+//
+// DSU is the single-threaded one: union by rank, and an iterative find with
+// path halving (every node on the way is pointed at its grandparent), so an
+// adversarial chain costs a loop instead of a recursion as deep as the chain.
+struct DSU {
+    int n;
+    std::vector<int> parent;
+    std::vector<unsigned char> rank;  // <= log2(n)
+
+    explicit DSU(int n = 0) : n(n), parent(n), rank(n, 0) {
+        for (int i = 0; i < n; i++) parent[i] = i;
+    }
+
+    int find(int x) {
+        MST_STAT_TIME(dsu.find);
+        int steps = 0;
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+            ++steps;
+        }
+        MST_STAT_SAMPLE(dsu.path, steps);
+        return x;
+    }
+
+    // returns the root of the merged set (the common root if already merged)
+    int unite(int a, int b) {
+        MST_STAT_TIME(dsu.unite);
+        a = find(a);
+        b = find(b);
+        if (a == b) return a;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+        return a;
+    }
+
+    bool same(int a, int b) { return find(a) == find(b); }
+};
+
+// ConcurrentDSU may be used from any number of threads at once, with no
+// locks. Links go by index: the root with the smaller index is hung below
+// the larger one with a single CAS on its parent word. So every non-root has
+// parent[x] > x, which keeps the forest acyclic whatever order the threads'
+// writes land in, and relaxed atomics suffice.
+//
+// find() does path halving through CAS; a failed CAS just means another
+// thread already moved that pointer further up, so find never retries and
+// finishes in as many steps as the path is long. unite() retries only when
+// a concurrent unite hung one of its roots first.
+class ConcurrentDSU {
+public:
+    explicit ConcurrentDSU(int n = 0) : parent(n) {
+        for (int i = 0; i < n; i++) parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    int size() const { return (int)parent.size(); }
+
+    int find(int x) {
+        MST_STAT_TIME(concurrent_dsu.find);
+        int steps = 0;
+        while (true) {
+            int p = parent[x].load(std::memory_order_relaxed);
+            if (p == x) {
+                MST_STAT_SAMPLE(concurrent_dsu.path, steps);
+                return x;
+            }
+            int gp = parent[p].load(std::memory_order_relaxed);
+            if (gp != p && !parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed))
+                MST_STAT_COUNT(concurrent_dsu.cas_failures);
+            steps += gp == p ? 1 : 2;
+            x = gp;
+        }
+    }
+
+    // true if this call merged two different sets
+    bool unite(int a, int b) {
+        MST_STAT_TIME(concurrent_dsu.unite);
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a > b) std::swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return true;
+            MST_STAT_COUNT(concurrent_dsu.unite_retries);
+        }
+    }
+
+    // a and b are only known to be apart if a is still a root after both finds
+    bool same(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return true;
+            if (parent[a].load(std::memory_order_relaxed) == a) return false;
+        }
+    }
+
+private:
+    std::vector<std::atomic<int>> parent;
+};
@@ -0,0 +1,262 @@
+#pragma once
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Zero-copy text input for the MST programs.
+//
+// InputBuffer maps the input file read-only (or, for stdin / pipes, slurps
+// it with read(2) into one buffer) and TextParser walks the bytes with
+// hand-rolled number parsing: no iostream, no locale, no per-token copy.
+// loadEdgeList() uses both to fill an edge array from the usual
+//
+//   n m
+//   u v w      (m lines)
+//
+// format in a single pass.
+class InputBuffer {
+public:
+    InputBuffer() = default;
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+    InputBuffer(InputBuffer&& o) noexcept { *this = std::move(o); }
+    InputBuffer& operator=(InputBuffer&& o) noexcept {
+        std::swap(ptr, o.ptr);
+        std::swap(len, o.len);
+        std::swap(mapped, o.mapped);
+        std::swap(owned, o.owned);
+        return *this;
+    }
+    ~InputBuffer() {
+        if (mapped) munmap(const_cast<char*>(ptr), len);
+    }
+
+    // path == nullptr or "-" reads stdin; returns false with errno set on failure
+    bool open(const char* path) {
+        int fd = 0;
+        if (path != nullptr && std::string(path) != "-") {
+            fd = ::open(path, O_RDONLY);
+            if (fd < 0) return false;
+        }
+        struct stat st;
+        bool ok = true;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+                ptr = static_cast<const char*>(p);
+                len = (size_t)st.st_size;
+                mapped = true;
+            } else {
+                ok = slurp(fd);
+            }
+        } else {
+            ok = slurp(fd);
+        }
+        if (fd != 0) ::close(fd);
+        return ok;
+    }
+
+    const char* data() const { return ptr; }
+    std::size_t size() const { return len; }
+
+private:
+    const char* ptr = nullptr;
+    std::size_t len = 0;
+    bool mapped = false;
+    std::vector<char> owned;
+
+    bool slurp(int fd) {
+        std::size_t cap = 1 << 20;
+        owned.resize(cap);
+        std::size_t used = 0;
+        for (;;) {
+            if (used == cap) owned.resize(cap *= 2);
+            ssize_t got = ::read(fd, owned.data() + used, cap - used);
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (got == 0) break;
+            used += (std::size_t)got;
+        }
+        ptr = owned.data();
+        len = used;
+        return true;
+    }
+};
+
+class TextParser {
+public:
+    TextParser(const char* begin, const char* end) : p(begin), end(end) {}
+
+    // where the next token would start (or where a malformed one stopped)
+    const char* pos() const { return p; }
+
+    // each returns false at end of input or on a malformed token, which
+    // includes a value out of the target type's range
+    bool next(long long& out) {
+        skip_space();
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) neg = *p++ == '-';
+        if (p == end || (unsigned)(*p - '0') > 9) return false;
+        const unsigned long long limit = neg ? (unsigned long long)LLONG_MAX + 1 : (unsigned long long)LLONG_MAX;
+        unsigned long long v = 0;
+        while (p < end && (unsigned)(*p - '0') <= 9) {
+            unsigned d = (unsigned)(*p - '0');
+            if (v > (limit - d) / 10) return false;
+            v = v * 10 + d;
+            p++;
+        }
+        out = neg ? (long long)(0 - v) : (long long)v;
+        return true;
+    }
+
+    bool next(int& out) {
+        long long v;
+        if (!next(v)) return false;
+        if (v < INT_MIN || v > INT_MAX) return false;
+        out = (int)v;
+        return true;
+    }
+
+    // Decimal with optional fraction and exponent. Mantissas of up to 19
+    // digits with a small power of ten convert exactly with one multiply or
+    // divide (both operands are exact doubles, so the result is correctly
+    // rounded); anything else goes to std::from_chars.
+    bool next(double& out) {
+        skip_space();
+        const char* start = p;
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) neg = *p++ == '-';
+        std::uint64_t mant = 0;
+        int digits = 0, scale = 0;
+        bool any = false;
+        while (p < end && (unsigned)(*p - '0') <= 9) {
+            if (digits < 19) {
+                mant = mant * 10 + (unsigned)(*p - '0');
+                if (mant != 0) digits++;
+            } else {
+                scale++;
+            }
+            p++;
+            any = true;
+        }
+        if (p < end && *p == '.') {
+            p++;
+            while (p < end && (unsigned)(*p - '0') <= 9) {
+                if (digits < 19) {
+                    mant = mant * 10 + (unsigned)(*p - '0');
+                    if (mant != 0) digits++;
+                    scale--;
+                }
+                p++;
+                any = true;
+            }
+        }
+        if (!any) return false;
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            long long e;
+            if (!next_exponent(e)) return slow_double(start, out);
+            scale += (int)e;
+        }
+        static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                       1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                       1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        if (mant >> 53 != 0 || scale < -22 || scale > 22) return slow_double(start, out);
+        double v = (double)mant;
+        v = scale < 0 ? v / pow10[-scale] : v * pow10[scale];
+        out = neg ? -v : v;
+        return true;
+    }
+
+private:
+    const char* p;
+    const char* end;
+
+    void skip_space() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+    }
+
+    bool next_exponent(long long& e) {
+        const char* save = p;
+        p++;  // 'e'
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) neg = *p++ == '-';
+        if (p == end || (unsigned)(*p - '0') > 9) {
+            p = save;
+            return false;
+        }
+        long long v = 0;
+        while (p < end && (unsigned)(*p - '0') <= 9) {
+            if (v < 100000) v = v * 10 + (*p - '0');
+            p++;
+        }
+        e = neg ? -v : v;
+        return true;
+    }
+
+    bool slow_double(const char* start, double& out) {
+        if (start < end && *start == '+') start++;
+        auto r = std::from_chars(start, end, out);
+        if (r.ec != std::errc()) return false;  // malformed, or out of double's range
+        p = r.ptr;
+        return true;
+    }
+};
+
+// Reads "n m" followed by m "u v w" triples into edges. Vertex ids in the
+// file are `base`-indexed (1 for Prim / Boruvka input, 0 for Fredman-Tarjan)
+// and are stored 0-indexed. EdgeT needs members u, v, w; w is parsed as
+// whatever type EdgeT::w has. Returns false on I/O error, a malformed or
+// missing number, or a vertex id outside [base, base + n); then *error, if
+// given, says which, with the line number for the last three.
+template <class EdgeT>
+bool loadEdgeList(const char* path, int& n, std::vector<EdgeT>& edges, int base, std::string* error = nullptr) {
+    InputBuffer in;
+    if (!in.open(path)) {
+        if (error != nullptr) *error = std::strerror(errno);
+        return false;
+    }
+    TextParser tp(in.data(), in.data() + in.size());
+    // the line tp stopped on, counted only once something is wrong
+    auto fail = [&](const char* what) {
+        if (error != nullptr) {
+            std::size_t line = 1;
+            for (const char* c = in.data(); c < tp.pos(); c++) line += *c == '\n';
+            *error = std::string(what) + " at line " + std::to_string(line);
+        }
+        return false;
+    };
+    long long m;
+    if (!tp.next(n) || !tp.next(m))
+        return fail(tp.pos() == in.data() + in.size() ? "missing header" : "malformed number");
+    if (n < 0 || m < 0) return fail("negative vertex or edge count");
+    // an edge takes at least six bytes ("u v w" and a separator), so a
+    // corrupt count fails here rather than in the resize
+    std::size_t left = (std::size_t)(in.data() + in.size() - tp.pos());
+    if ((unsigned long long)m > left / 6) return fail("edge count larger than the input");
+    edges.resize((std::size_t)m);
+    for (EdgeT& e : edges) {
+        long long u, v;
+        if (!tp.next(u) || !tp.next(v) || !tp.next(e.w))
+            return fail(tp.pos() == in.data() + in.size() ? "unexpected end of input" : "malformed number");
+        u -= base;
+        v -= base;
+        if (u < 0 || u >= n || v < 0 || v >= n) return fail("vertex id out of range");
+        e.u = (int)u;
+        e.v = (int)v;
+    }
+    return true;
+}
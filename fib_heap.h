@@ -0,0 +1,445 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "mst_stats.h"
+#include "node_pool.h"
+
+// Fibonacci heap shared by all the MST programs.
+//
+//   FibHeap<Key, Payload, Compare>
+//
+// insert() returns a handle that stays valid until that element leaves the
+// heap (extract_min / erase), so callers can keep handles around for
+// decrease_key() the way Prim does with one handle per vertex.
+//
+// Nodes come from a NodePool. By default each heap owns one, created on the
+// first insert; heaps that are melded together (one per component in
+// Boruvka / Fredman-Tarjan) should share a per-run pool instead. A heap on a
+// shared pool does not walk its nodes on destruction when they are trivially
+// destructible: the pool's reset() reclaims them in bulk.
+//
+// Built with -DMST_STATS, the heap counts its links, cuts and consolidations
+// and times its operations (mst_stats.h).
+template <class Key, class Payload, class Compare = std::less<Key>>
+class FibHeap {
+public:
+    struct Node {
+        Key key;
+        Payload payload;
+        Node *parent, *child, *left, *right;
+        int degree;
+        bool mark;
+    };
+    using handle = Node*;
+    using Pool = NodePool<Node>;
+
+    // what extract_min hands back once the node itself has been released
+    struct Entry {
+        Key key;
+        Payload payload;
+    };
+
+    explicit FibHeap(Compare cmp = Compare()) : minimum(nullptr), n(0), less(cmp), pool(nullptr) {}
+    explicit FibHeap(Pool& shared, Compare cmp = Compare())
+        : minimum(nullptr), n(0), less(cmp), pool(&shared) {}
+    ~FibHeap() {
+        if (!std::is_trivially_destructible<Node>::value || pool == owned_pool.get()) clear();
+    }
+
+    FibHeap(const FibHeap&) = delete;
+    FibHeap& operator=(const FibHeap&) = delete;
+    FibHeap(FibHeap&& o) noexcept
+        : minimum(o.minimum), n(o.n), less(o.less), pool(o.pool), owned_pool(std::move(o.owned_pool)) {
+        o.minimum = nullptr;
+        o.n = 0;
+        o.pool = nullptr;
+    }
+    FibHeap& operator=(FibHeap&& o) noexcept {
+        if (this != &o) {
+            clear();
+            minimum = o.minimum;
+            n = o.n;
+            less = o.less;
+            pool = o.pool;
+            owned_pool = std::move(o.owned_pool);
+            o.minimum = nullptr;
+            o.n = 0;
+            o.pool = nullptr;
+        }
+        return *this;
+    }
+
+    bool empty() const { return minimum == nullptr; }
+    std::size_t size() const { return n; }
+    handle get_min() const { return minimum; }
+
+    // pre-size the node pool so the next `count` inserts never hit malloc
+    void reserve(std::size_t count) { node_pool().reserve(count); }
+    const Pool* get_pool() const { return pool; }
+
+    handle insert(const Key& key, Payload payload) {
+        MST_STAT_TIME(fib.insert);
+        Node* x = node_pool().create(key, std::move(payload), nullptr, nullptr, nullptr, nullptr, 0, false);
+        x->left = x->right = x;
+        add_root(x);
+        if (less(x->key, minimum->key)) minimum = x;
+        ++n;
+        return x;
+    }
+
+    // Bulk insert of [first, last), elements with members key and payload
+    // (Entry, say). The new roots are chained among themselves and spliced
+    // into the root list in one step, and the minimum is updated once. The
+    // i-th element's handle goes to out[i] unless out is null.
+    template <class It>
+    void insert_range(It first, It last, handle* out = nullptr) {
+        if (first == last) return;
+        MST_STAT_TIME(fib.insert_range);
+        Pool& p = node_pool();
+        Node *head = nullptr, *tail = nullptr, *best = nullptr;
+        std::size_t count = 0;
+        for (; first != last; ++first, ++count) {
+            Node* x = p.create(first->key, Payload(first->payload), nullptr, nullptr, nullptr, nullptr, 0, false);
+            if (head == nullptr) {
+                head = x;
+            } else {
+                tail->right = x;
+                x->left = tail;
+            }
+            tail = x;
+            if (best == nullptr || less(x->key, best->key)) best = x;
+            if (out != nullptr) out[count] = x;
+        }
+        head->left = tail;
+        tail->right = head;
+        splice_roots(head);
+        if (less(best->key, minimum->key)) minimum = best;
+        n += count;
+    }
+
+    // O(1): splice other's root list into ours; other is left empty.
+    // Both heaps should use the same pool; if other owns a private pool
+    // its slabs are taken over along with the nodes.
+    void meld(FibHeap& other) {
+        if (this == &other || other.minimum == nullptr) return;
+        MST_STAT_TIME(fib.meld);
+        if (other.pool != pool) {
+            if (pool == nullptr) {
+                pool = other.pool;
+                owned_pool = std::move(other.owned_pool);
+                other.pool = nullptr;
+            } else {
+                assert(other.owned_pool != nullptr && "melding heaps on different shared pools");
+                pool->adopt(*other.owned_pool);
+            }
+        }
+        if (minimum == nullptr) {
+            minimum = other.minimum;
+        } else {
+            Node* a = minimum->left;
+            Node* b = other.minimum->left;
+            a->right = other.minimum;
+            other.minimum->left = a;
+            b->right = minimum;
+            minimum->left = b;
+            if (less(other.minimum->key, minimum->key)) minimum = other.minimum;
+        }
+        n += other.n;
+        other.minimum = nullptr;
+        other.n = 0;
+    }
+
+    // removes the minimum; heap must not be empty
+    Entry extract_min() {
+        MST_STAT_TIME(fib.extract_min);
+        Node* z = minimum;
+        // splice z's whole child list into the root list next to z; their
+        // parent pointers are cleared when consolidate() walks the roots
+        if (z->child != nullptr) {
+            Node* first = z->child;
+            Node* last = first->left;
+            z->left->right = first;
+            first->left = z->left;
+            last->right = z;
+            z->left = last;
+            z->child = nullptr;
+        }
+        if (z->right == z) {
+            minimum = nullptr;
+        } else {
+            minimum = z->right;
+            remove_from_list(z);
+            consolidate();
+        }
+        --n;
+        Entry e{std::move(z->key), std::move(z->payload)};
+        pool->destroy(z);
+        return e;
+    }
+
+    // lowers x's key to k; a k that is not smaller than the current key is ignored
+    void decrease_key(handle x, const Key& k) {
+        MST_STAT_TIME(fib.decrease_key);
+        if (less(x->key, k)) return;
+        x->key = k;
+        Node* y = x->parent;
+        if (y != nullptr && less(x->key, y->key)) {
+            cut(x, y);
+            cascading_cut(y);
+        }
+        if (less(x->key, minimum->key)) minimum = x;
+    }
+
+    // Batched decrease_key over [first, last), elements with members first
+    // (the handle) and second (the new key), e.g. std::pair<handle, Key>.
+    // All cuts are made first, with the cut nodes gathered in one list
+    // that joins the root list in a single splice; then the cascading cuts
+    // of the parents they left run together, and the minimum is updated
+    // once. Same semantics as one decrease_key per element: keys that are
+    // not smaller are ignored, and a handle may appear more than once.
+    template <class It>
+    void decrease_keys(It first, It last) {
+        MST_STAT_TIME(fib.decrease_keys);
+        Node *cutList = nullptr, *best = nullptr;
+        std::vector<Node*>& parents = cascade_scratch();
+        for (; first != last; ++first) {
+            Node* x = first->first;
+            if (less(x->key, first->second)) continue;
+            x->key = first->second;
+            Node* y = x->parent;
+            if (y != nullptr) {
+                if (!less(x->key, y->key)) continue;
+                detach(x, y);
+                push_list(cutList, x);
+                parents.push_back(y);
+            }
+            if (best == nullptr || less(x->key, best->key)) best = x;
+        }
+        for (Node* y : parents) {
+            for (Node* z = y->parent; z != nullptr; y = z, z = y->parent) {
+                if (!y->mark) {
+                    y->mark = true;
+                    MST_STAT_COUNT(fib.marks);
+                    break;
+                }
+                MST_STAT_COUNT(fib.cascading_cuts);
+                detach(y, z);
+                push_list(cutList, y);
+            }
+        }
+        parents.clear();
+        if (cutList != nullptr) splice_roots(cutList);
+        if (best != nullptr && less(best->key, minimum->key)) minimum = best;
+    }
+
+    // removes an arbitrary element without needing a "minus infinity" key
+    void erase(handle x) {
+        MST_STAT_TIME(fib.erase);
+        Node* y = x->parent;
+        if (y != nullptr) {
+            cut(x, y);
+            cascading_cut(y);
+        }
+        minimum = x;
+        extract_min();
+    }
+
+    void clear() {
+        if (minimum == nullptr) return;
+        if (std::is_trivially_destructible<Node>::value && pool == owned_pool.get()) {
+            // every node in our private pool is ours: drop them all at once
+            pool->reset();
+        } else {
+            std::vector<Node*> stack{minimum};
+            while (!stack.empty()) {
+                Node* start = stack.back();
+                stack.pop_back();
+                Node* cur = start;
+                do {
+                    Node* next = cur->right;
+                    if (cur->child) stack.push_back(cur->child);
+                    pool->destroy(cur);
+                    cur = next;
+                } while (cur != start);
+            }
+        }
+        minimum = nullptr;
+        n = 0;
+    }
+
+private:
+    Node* minimum;
+    std::size_t n;
+    Compare less;
+    Pool* pool;
+    std::unique_ptr<Pool> owned_pool;
+
+    Pool& node_pool() {
+        if (pool == nullptr) {
+            owned_pool.reset(new Pool());
+            pool = owned_pool.get();
+        }
+        return *pool;
+    }
+
+    // insert x (already a singleton list) into the root list
+    void add_root(Node* x) {
+        if (minimum == nullptr) {
+            x->left = x->right = x;
+            minimum = x;
+        } else {
+            x->left = minimum->left;
+            x->right = minimum;
+            minimum->left->right = x;
+            minimum->left = x;
+        }
+    }
+
+    // join the circular list starting at head into the (non-empty) root list
+    void splice_roots(Node* head) {
+        if (minimum == nullptr) {
+            minimum = head;
+            return;
+        }
+        Node* tail = head->left;
+        Node* a = minimum->left;
+        a->right = head;
+        head->left = a;
+        tail->right = minimum;
+        minimum->left = tail;
+    }
+
+    // add the singleton x to the circular list at head (null: empty list)
+    static void push_list(Node*& head, Node* x) {
+        if (head == nullptr) {
+            head = x;
+            return;
+        }
+        x->left = head->left;
+        x->right = head;
+        head->left->right = x;
+        head->left = x;
+    }
+
+    static void remove_from_list(Node* x) {
+        x->left->right = x->right;
+        x->right->left = x->left;
+        x->left = x->right = x;
+    }
+
+    // make y a child of x; y must already be detached (a singleton list)
+    void link(Node* y, Node* x) {
+        if (x->child == nullptr) {
+            x->child = y;
+        } else {
+            y->left = x->child->left;
+            y->right = x->child;
+            x->child->left->right = y;
+            x->child->left = y;
+        }
+        y->parent = x;
+        x->degree += 1;
+        y->mark = false;
+        MST_STAT_COUNT(fib.links);
+    }
+
+    // Scratch for consolidate(), indexed by degree. It is shared by every heap
+    // of this type on the thread and always left all-null, so consolidation
+    // never allocates once it has grown to the degree bound.
+    static std::vector<Node*>& degree_table(std::size_t count) {
+        // a root of degree d roots a tree of at least F(d+2) >= phi^d nodes
+        int bound = (int)(std::log2((double)count + 1) * 1.4404200904125564) + 2;
+        static thread_local std::vector<Node*> table;
+        if ((int)table.size() < bound) table.resize(bound, nullptr);
+        return table;
+    }
+
+    void consolidate() {
+        std::vector<Node*>& A = degree_table(n);
+        int top = -1;
+        std::size_t roots = 0;
+
+        // open the circular root list and detach each root as we pass it, so
+        // link() only ever touches nodes that are no longer in the list
+        Node* w = minimum;
+        w->left->right = nullptr;
+        while (w != nullptr) {
+            Node* next = w->right;
+            Node* x = w;
+            x->left = x->right = x;
+            x->parent = nullptr;
+            x->mark = false;
+            int d = x->degree;
+            while (A[d] != nullptr) {
+                Node* y = A[d];
+                A[d] = nullptr;
+                if (less(y->key, x->key)) std::swap(x, y);
+                link(y, x);
+                ++d;
+            }
+            assert(d < (int)A.size());
+            A[d] = x;
+            if (d > top) top = d;
+            w = next;
+            ++roots;
+        }
+        MST_STAT_SAMPLE(fib.root_list, roots);
+        MST_STAT_SAMPLE(fib.max_degree, top);
+
+        // rebuild root list from A, clearing it for the next call
+        minimum = nullptr;
+        for (int d = 0; d <= top; ++d) {
+            Node* node = A[d];
+            if (node == nullptr) continue;
+            A[d] = nullptr;
+            add_root(node);
+            if (less(node->key, minimum->key)) minimum = node;
+        }
+    }
+
+    // x is a child of y: move x to the root list
+    void cut(Node* x, Node* y) {
+        detach(x, y);
+        add_root(x);
+    }
+
+    // take x out of y's child list, leaving it a parentless singleton
+    static void detach(Node* x, Node* y) {
+        if (x->right == x) {
+            y->child = nullptr;
+        } else {
+            if (y->child == x) y->child = x->right;
+            remove_from_list(x);
+        }
+        y->degree -= 1;
+        x->parent = nullptr;
+        x->mark = false;
+        MST_STAT_COUNT(fib.cuts);
+    }
+
+    // parents awaiting their cascading cut in decrease_keys(), shared like
+    // the degree table and always left empty
+    static std::vector<Node*>& cascade_scratch() {
+        static thread_local std::vector<Node*> parents;
+        return parents;
+    }
+
+    void cascading_cut(Node* y) {
+        for (Node* z = y->parent; z != nullptr; y = z, z = y->parent) {
+            if (!y->mark) {
+                y->mark = true;
+                MST_STAT_COUNT(fib.marks);
+                return;
+            }
+            MST_STAT_COUNT(fib.cascading_cuts);
+            cut(y, z);
+        }
+    }
+};
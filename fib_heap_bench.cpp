@@ -0,0 +1,88 @@
+// Microbenchmark for the Fibonacci heap hot path.
+//
+//   g++ -O2 -std=c++17 fib_heap_bench.cpp -o fib_heap_bench
+//   ./fib_heap_bench [n] [rounds]
+//
+// For FibHeap and CompactFibHeap: insert n random keys, then extract them
+// all, and separately a Prim-like mix of decrease_key + extract_min.
+// Reports ns per extract_min and how many operator new calls each phase
+// made, counted by the replacement operator new below.
+#include <bits/stdc++.h>
+#include "compact_fib_heap.h"
+#include "fib_heap.h"
+using namespace std;
+
+static size_t g_allocs = 0;
+void* operator new(size_t sz) {
+    ++g_allocs;
+    if (void* p = malloc(sz ? sz : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+using Clock = chrono::steady_clock;
+
+static double nsSince(Clock::time_point t0, size_t ops) {
+    return chrono::duration<double, nano>(Clock::now() - t0).count() / max<size_t>(ops, 1);
+}
+
+template <class Heap>
+void run(const char* name, const vector<long long>& keys, int rounds) {
+    size_t n = keys.size();
+    double bestExtract = 1e18, bestMix = 1e18;
+    size_t extractAllocs = 0, mixAllocs = 0;
+    mt19937 rng(7);
+    for (int r = 0; r < rounds; r++) {
+        // plain drain: n inserts, then n extract_min
+        {
+            Heap H;
+            H.reserve(n);
+            for (size_t i = 0; i < n; i++) H.insert(keys[i], (int)i);
+            size_t a0 = g_allocs;
+            auto t0 = Clock::now();
+            long long sink = 0;
+            while (!H.empty()) sink += H.extract_min().key;
+            bestExtract = min(bestExtract, nsSince(t0, n));
+            extractAllocs = g_allocs - a0;
+            if (sink == 42) puts("");
+        }
+        // Prim-like: every extraction is followed by a few decrease_keys
+        {
+            Heap H;
+            H.reserve(n);
+            vector<typename Heap::handle> h(n);
+            vector<long long> cur(keys);
+            vector<char> alive(n, 1);
+            for (size_t i = 0; i < n; i++) h[i] = H.insert(keys[i], (int)i);
+            size_t a0 = g_allocs;
+            auto t0 = Clock::now();
+            while (!H.empty()) {
+                int u = H.extract_min().payload;
+                alive[u] = 0;
+                for (int k = 0; k < 4; k++) {
+                    size_t v = rng() % n;
+                    if (!alive[v] || cur[v] == 0) continue;
+                    cur[v] -= 1 + cur[v] / 4;
+                    H.decrease_key(h[v], cur[v]);
+                }
+            }
+            bestMix = min(bestMix, nsSince(t0, n));
+            mixAllocs = g_allocs - a0;
+        }
+    }
+    printf("%-16s n=%-9zu extract_min %8.1f ns  (allocs %zu)   decrease+extract %8.1f ns  (allocs %zu)\n",
+           name, n, bestExtract, extractAllocs, bestMix, mixAllocs);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 3;
+    mt19937_64 rng(12345);
+    vector<long long> keys(n);
+    for (auto& k : keys) k = (long long)(rng() % 1000000000);
+
+    run<FibHeap<long long, int>>("FibHeap", keys, rounds);
+    run<CompactFibHeap<long long, int>>("CompactFibHeap", keys, rounds);
+    return 0;
+}
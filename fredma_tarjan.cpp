@@ -1,4 +1,9 @@
 #include <bits/stdc++.h>
+#include "compact_fib_heap.h"
+#include "fib_heap.h"
+#include "graph_binary.h"
+#include "heap_batch.h"
+#include "output_writer.h"
 using namespace std;
 
 // ------------------- Edge structure -------------------
@@ -7,235 +12,242 @@ struct Edge {
     double w;
 };
 
-// ------------------- Disjoint Set Union -------------------
-struct DSU {
-    vector<int> parent, rank;
-    DSU(int n) {
-        parent.resize(n);
-        rank.assign(n, 0);
-        iota(parent.begin(), parent.end(), 0);
-    }
-    int find(int x) {
-        return parent[x] == x ? x : parent[x] = find(parent[x]);
-    }
-    bool unite(int x, int y) {
-        x = find(x);
-        y = find(y);
-        if (x == y) return false;
-        if (rank[x] < rank[y]) swap(x, y);
-        parent[y] = x;
-        if (rank[x] == rank[y]) rank[x]++;
-        return true;
-    }
-};
+// ------------------- Fibonacci Heap -------------------
+// Vertex-keyed heap of one growing tree: key = cheapest known edge from the
+// tree to the vertex, payload = the vertex. Every tree's heap draws nodes
+// from one pool owned by the caller, which is reset between trees.
+using EdgeHeap = FibHeap<double, int>;
+// --compact: 32-bit index links, 32-byte hot records
+using CompactEdgeHeap = CompactFibHeap<double, int>;
+
+// adjacency with the input edge index of every arc
+using Graph = CsrGraph<double>;
+
+// A directed edge id is 2*i for edges[i] as given, 2*i+1 for its reverse.
+inline Edge directedEdge(ArrayView<Edge> edges, int id) {
+    const Edge& e = edges[id >> 1];
+    return (id & 1) ? Edge{e.v, e.u, e.w} : e;
+}
 
-// ------------------- Fibonacci Heap (minimal version) -------------------
-struct FibNode {
-    Edge edge; 
-    double key;
-    FibNode *parent, *child, *left, *right;
-    int degree;
-    bool mark;
-    FibNode(const Edge &e) : edge(e), key(e.w), parent(nullptr), child(nullptr),
-                             degree(0), mark(false) {
-        left = right = this;
-    }
+// Edge of a contracted graph: u, v are trees of the previous phase and id
+// is the directed input edge it stands for, oriented u -> v.
+struct PhaseEdge {
+    int u, v;
+    double w;
+    int id;
 };
 
-struct FibHeap {
-    FibNode* minNode;
-    int nNodes;
-
-    FibHeap() : minNode(nullptr), nNodes(0) {}
-
-    void insertNode(FibNode* x) {
-        if (!minNode) {
-            minNode = x;
-        } else {
-            // insert x into root list
-            x->left = minNode;
-            x->right = minNode->right;
-            minNode->right->left = x;
-            minNode->right = x;
-            if (x->key < minNode->key)
-                minNode = x;
-        }
-        nNodes++;
-    }
-
-    void insertEdge(const Edge& e) {
-        insertNode(new FibNode(e));
-    }
-
-    FibNode* extractMin() {
-        FibNode* z = minNode;
-        if (z) {
-            // add children to root list
-            if (z->child) {
-                FibNode* c = z->child;
-                do {
-                    FibNode* next = c->right;
-                    // remove c from child list
-                    c->parent = nullptr;
-                    // add to root list
-                    c->left = minNode;
-                    c->right = minNode->right;
-                    minNode->right->left = c;
-                    minNode->right = c;
-                    c = next;
-                } while (c != z->child);
-            }
-            // remove z from root list
-            z->left->right = z->right;
-            z->right->left = z->left;
-            if (z == z->right)
-                minNode = nullptr;
-            else {
-                minNode = z->right;
-                consolidate();
+// ------------------- Fredman-Tarjan MST -------------------
+// One phase: grow trees one at a time from a vertex-keyed Fibonacci heap
+// (Prim with decrease_key), stopping a tree as soon as its heap holds more
+// than k = 2^(2m/n) vertices or it reaches a tree grown earlier in the
+// phase, to which it is then linked. Every extracted edge is the lightest
+// one leaving its tree, so it goes into the MST. arcEdge[a] is the directed
+// input edge id of arc a. Sets label[v] to the component of v after the
+// phase's links and returns the number of components.
+template <class Heap>
+int growTrees(const Graph& g, const vector<int>& arcEdge, typename Heap::Pool& pool, vector<int>& mst,
+              vector<int>& label) {
+    int n = g.n;
+    double k = exp2(min((double)g.arcs() / max(n, 1), 62.0));
+    vector<int> tree(n, -1), inHeap(n, -1), via(n);
+    vector<double> key(n);
+    vector<typename Heap::handle> node(n);
+    vector<int> link;  // link[t]: earlier tree that tree t ran into, or -1
+    HeapBatch<Heap> batch;  // one bulk insert / decrease per scanned vertex
+    for (int s = 0; s < n; s++) {
+        if (tree[s] != -1) continue;
+        int t = (int)link.size();
+        link.push_back(-1);
+        {
+            Heap H(pool);
+            int u = s;
+            while (true) {
+                tree[u] = t;
+                batch.begin(g.end(u) - g.begin(u));
+                for (size_t a = g.begin(u); a < g.end(u); a++) {
+                    int v = g.target[a];
+                    if (tree[v] == t) continue;
+                    double w = g.weight[a];
+                    if (inHeap[v] != t) {
+                        inHeap[v] = t;
+                        key[v] = w;
+                        via[v] = arcEdge[a];
+                        batch.insert(H, w, v, node[v]);
+                    } else if (w < key[v]) {
+                        key[v] = w;
+                        via[v] = arcEdge[a];
+                        batch.decrease_key(H, node[v], w);
+                    }
+                }
+                batch.flush(H);
+                if (H.empty() || H.size() > k) break;
+                u = H.extract_min().payload;
+                mst.push_back(via[u]);
+                if (tree[u] != -1) {
+                    link[t] = tree[u];
+                    break;
+                }
             }
-            nNodes--;
         }
-        return z;
+        pool.reset();  // the heap's leftover nodes
     }
 
-    void consolidate() {
-        int D = 64; // max degree
-        vector<FibNode*> A(D, nullptr);
-        vector<FibNode*> rootList;
-        if (!minNode) return;
-        FibNode* start = minNode;
-        FibNode* w = start;
-        do {
-            rootList.push_back(w);
-            w = w->right;
-        } while (w != start);
+    // links always point to an earlier tree, so one forward pass resolves them
+    vector<int> comp(link.size());
+    int components = 0;
+    for (size_t t = 0; t < link.size(); t++) comp[t] = link[t] == -1 ? components++ : comp[link[t]];
+    label.resize(n);
+    for (int v = 0; v < n; v++) label[v] = comp[tree[v]];
+    return components;
+}
 
-        for (FibNode* w : rootList) {
-            FibNode* x = w;
-            int d = x->degree;
-            while (A[d]) {
-                FibNode* y = A[d];
-                if (x->key > y->key) swap(x, y);
-                fibHeapLink(y, x);
-                A[d] = nullptr;
-                d++;
-            }
-            A[d] = x;
-        }
-        minNode = nullptr;
-        for (FibNode* a : A) {
-            if (a) {
-                if (!minNode) {
-                    minNode = a->left = a->right = a;
-                } else {
-                    a->left = minNode;
-                    a->right = minNode->right;
-                    minNode->right->left = a;
-                    minNode->right = a;
-                    if (a->key < minNode->key)
-                        minNode = a;
-                }
-            }
+// Contract every component to a single vertex: drop the edges inside one and
+// keep only the lightest of each bundle of parallel edges. Buckets the edges
+// by their smaller endpoint, then dedups each bucket through slot[], O(n + m).
+// Components with no edges left are finished and disappear; the others are
+// renumbered densely and `components` becomes their count.
+vector<PhaseEdge> contract(const Graph& g, const vector<int>& arcEdge, const vector<int>& label, int& components) {
+    vector<size_t> start(components + 1, 0);
+    for (int u = 0; u < g.n; u++) {
+        for (size_t a = g.begin(u); a < g.end(u); a++) {
+            int v = g.target[a];
+            if (u < v && label[u] != label[v]) start[min(label[u], label[v]) + 1]++;
         }
     }
-
-    void fibHeapLink(FibNode* y, FibNode* x) {
-        // remove y from root list
-        y->left->right = y->right;
-        y->right->left = y->left;
-        // make y child of x
-        y->parent = x;
-        if (!x->child) {
-            x->child = y->left = y->right = y;
-        } else {
-            y->left = x->child;
-            y->right = x->child->right;
-            x->child->right->left = y;
-            x->child->right = y;
+    for (int c = 0; c < components; c++) start[c + 1] += start[c];
+    vector<PhaseEdge> bucket(start[components]);
+    vector<size_t> fill(start.begin(), start.end() - 1);
+    for (int u = 0; u < g.n; u++) {
+        for (size_t a = g.begin(u); a < g.end(u); a++) {
+            int v = g.target[a];
+            if (u >= v || label[u] == label[v]) continue;
+            PhaseEdge e{label[u], label[v], g.weight[a], arcEdge[a]};
+            if (e.u > e.v) {
+                swap(e.u, e.v);
+                e.id ^= 1;
+            }
+            bucket[fill[e.u]++] = e;
         }
-        x->degree++;
-        y->mark = false;
     }
 
-    void meld(FibHeap& other) {
-        if (!other.minNode) return;
-        if (!minNode) {
-            minNode = other.minNode;
-            nNodes = other.nNodes;
-            return;
+    vector<PhaseEdge> out;
+    vector<int> slot(components, -1);  // out index of the edge c -> v, per v
+    for (int c = 0; c < components; c++) {
+        for (size_t i = start[c]; i < start[c + 1]; i++) {
+            const PhaseEdge& e = bucket[i];
+            if (slot[e.v] == -1) {
+                slot[e.v] = (int)out.size();
+                out.push_back(e);
+            } else if (e.w < out[slot[e.v]].w) {
+                out[slot[e.v]] = e;
+            }
         }
-        // concatenate root lists
-        FibNode* min1Right = minNode->right;
-        FibNode* min2Left = other.minNode->left;
-        minNode->right = other.minNode;
-        other.minNode->left = minNode;
-        min1Right->left = min2Left;
-        min2Left->right = min1Right;
-        if (other.minNode->key < minNode->key)
-            minNode = other.minNode;
-        nNodes += other.nNodes;
+        for (size_t i = start[c]; i < start[c + 1]; i++) slot[bucket[i].v] = -1;
     }
 
-    bool empty() const {
-        return nNodes == 0;
+    // keeping isolated vertices would shrink k = 2^(2m/n) below the point
+    // where every phase is guaranteed to make progress
+    vector<int> renumber(components, -1);
+    int live = 0;
+    for (PhaseEdge& e : out) {
+        if (renumber[e.u] == -1) renumber[e.u] = live++;
+        if (renumber[e.v] == -1) renumber[e.v] = live++;
+        e.u = renumber[e.u];
+        e.v = renumber[e.v];
     }
-};
+    components = live;
+    return out;
+}
 
-// ------------------- Fredman-Tarjan MST -------------------
-vector<Edge> fredmanTarjanMST(int n, const vector<Edge>& edges) {
-    DSU dsu(n);
-    // Build adjacency for each component’s heap
-    vector<FibHeap> heaps(n);
-    for (auto &e : edges) {
-        int u = e.u, v = e.v;
-        heaps[u].insertEdge(e);
-        heaps[v].insertEdge({v,u,e.w}); // undirected
+// Phases on ever smaller contracted graphs until no edges are left. With
+// k = 2^(2m/n) every phase is O(m) and there are at most log* n of them.
+// Returns the MST (a spanning forest if g is disconnected) as directed edge
+// ids, in the order they were chosen.
+template <class Heap>
+vector<int> fredmanTarjanMST(const Graph& g, ArrayView<Edge> edges, typename Heap::Pool& pool,
+                             bool phaseStats = false) {
+    vector<int> arcEdge(g.arcs());
+    for (int u = 0; u < g.n; u++) {
+        for (size_t a = g.begin(u); a < g.end(u); a++) {
+            int i = g.edgeId[a];
+            arcEdge[a] = 2 * i + (edges[i].u != u);
+        }
     }
-
-    vector<Edge> mst;
-    int components = n;
-    while (components > 1) {
-        // for each component, pick min edge
-        for (int i = 0; i < n; i++) {
-            int ci = dsu.find(i);
-            // Skip empty heaps
-            if (heaps[ci].empty()) continue;
-            FibNode* node = heaps[ci].extractMin();
-            if (!node) continue;
-            Edge e = node->edge;
-            int u = e.u, v = e.v;
-            int cu = dsu.find(u), cv = dsu.find(v);
-            if (cu == cv) continue; // already same component
-            mst.push_back(e);
-            // Union components
-            if (dsu.unite(cu, cv)) {
-                components--;
-                int newRoot = dsu.find(cu);
-                int oldRoot = (newRoot == cu ? cv : cu);
-                heaps[newRoot].meld(heaps[oldRoot]);
+    vector<int> mst, label;
+    Graph contracted;
+    const Graph* cur = &g;
+    for (int phase = 1;; phase++) {
+        auto t0 = chrono::steady_clock::now();
+        int components = growTrees<Heap>(*cur, arcEdge, pool, mst, label);
+        vector<PhaseEdge> next = contract(*cur, arcEdge, label, components);
+        if (phaseStats) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            cerr << "phase " << phase << ": n " << cur->n << ", m " << cur->arcs() / 2 << " -> n " << components
+                 << ", m " << next.size() << ", " << ms << " ms\n";
+        }
+        if (next.empty()) break;
+
+        contracted = Graph::build(components, next, true);
+        arcEdge.resize(contracted.arcs());
+        for (int u = 0; u < components; u++) {
+            for (size_t a = contracted.begin(u); a < contracted.end(u); a++) {
+                const PhaseEdge& e = next[contracted.edgeId[a]];
+                arcEdge[a] = e.u == u ? e.id : e.id ^ 1;
             }
         }
+        cur = &contracted;
     }
     return mst;
 }
 
 // ------------------- Driver -------------------
-int main() {
-    int n, m;
-    cin >> n >> m;
-    vector<Edge> edges(m);
-    for (int i = 0; i < m; i++) {
-        cin >> edges[i].u >> edges[i].v >> edges[i].w;
+// --pool-stats:  node allocator counters on stderr
+// --compact:     use the index-based CompactFibHeap
+// --binary-out:  write the MST as an input edge index list instead of text
+// --phase-stats: per-phase graph sizes and times on stderr
+// [input]        text edge list (0-indexed) or binary graph file (default: stdin)
+int main(int argc, char** argv) {
+    bool poolStats = false, compact = false, binaryOut = false, phaseStats = false;
+    const char* input = nullptr;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--pool-stats") poolStats = true;
+        else if (arg == "--compact") compact = true;
+        else if (arg == "--binary-out") binaryOut = true;
+        else if (arg == "--phase-stats") phaseStats = true;
+        else input = argv[i];
+    }
+    LoadedGraph<Edge> in;
+    if (!in.load(input, 0, true)) {
+        cerr << (input ? input : "stdin") << ": " << in.error << "\n";
+        return 1;
+    }
+    const Graph& g = in.g;
+    ArrayView<Edge> edges = in.edges;
+    vector<int> mst;
+    if (compact) {
+        CompactEdgeHeap::Pool pool;
+        mst = fredmanTarjanMST<CompactEdgeHeap>(g, edges, pool, phaseStats);
+        if (poolStats) cerr << "compact pool: " << pool.stats() << "\n";
+    } else {
+        EdgeHeap::Pool pool;
+        mst = fredmanTarjanMST<EdgeHeap>(g, edges, pool, phaseStats);
+        if (poolStats) cerr << "pool: " << pool.stats() << "\n";
+    }
+    BufferedWriter out;
+    if (binaryOut) {
+        for (int& id : mst) id >>= 1;
+        writeEdgeIndexList(out, mst);
+        return 0;
     }
-
-    auto mst = fredmanTarjanMST(n, edges);
     double total = 0;
-    for (auto &e : mst) total += e.w;
+    for (int id : mst) total += edges[id >> 1].w;
 
-    cout << "MST weight: " << total << "\n";
-    for (auto &e : mst) {
-        cout << e.u << " - " << e.v << " : " << e.w << "\n";
+    out << "MST weight: " << total << "\n";
+    for (int id : mst) {
+        Edge e = directedEdge(edges, id);
+        out << e.u << " - " << e.v << " : " << e.w << "\n";
     }
     return 0;
 }
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Plain weighted edge, for programs that don't need their own Edge type.
+template <class W>
+struct WeightedEdge {
+    int u, v;
+    W w;
+};
+
+// Read-only view of a contiguous array: either a std::vector or memory
+// mapped straight from a binary graph file (graph_binary.h).
+template <class T>
+struct ArrayView {
+    const T* ptr = nullptr;
+    std::size_t len = 0;
+
+    ArrayView() = default;
+    ArrayView(const T* p, std::size_t n) : ptr(p), len(n) {}
+    ArrayView(const std::vector<T>& v) : ptr(v.data()), len(v.size()) {}
+
+    const T& operator[](std::size_t i) const { return ptr[i]; }
+    std::size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + len; }
+};
+
+// Immutable undirected graph in compressed sparse row form, shared by the
+// MST programs. The arcs of vertex u are [offset[u], offset[u+1]) in the
+// packed target / weight (and optionally edgeId) arrays, so scanning a
+// neighborhood is one sequential stream instead of a per-vertex vector.
+// Each input edge {u, v, w} becomes the arcs u->v and v->u, in input order.
+// Id may be a 32-bit type to halve the neighbor array on big graphs.
+//
+// The arrays are plain pointers: build() points them at vectors the graph
+// owns, view() at memory someone else keeps alive (a mapped graph file).
+template <class W, class Id = int>
+struct CsrGraph {
+    int n = 0;
+    const std::size_t* offset = nullptr;  // n + 1 entries
+    const Id* target = nullptr;
+    const W* weight = nullptr;
+    const int* edgeId = nullptr;  // index of the input edge; null unless requested
+
+    CsrGraph() = default;
+    CsrGraph(const CsrGraph&) = delete;
+    CsrGraph& operator=(const CsrGraph&) = delete;
+    // moving the vectors keeps their buffers, so the pointers stay valid
+    CsrGraph(CsrGraph&&) = default;
+    CsrGraph& operator=(CsrGraph&&) = default;
+
+    std::size_t begin(int u) const { return offset[u]; }
+    std::size_t end(int u) const { return offset[u + 1]; }
+    std::size_t degree(int u) const { return offset[u + 1] - offset[u]; }
+    std::size_t arcs() const { return n == 0 ? 0 : offset[n]; }
+
+    // O(n + m) counting-sort build; EdgeT needs members u, v, w (0-indexed)
+    template <class EdgeT>
+    static CsrGraph build(int n, ArrayView<EdgeT> edges, bool keepEdgeIds = false) {
+        CsrGraph g;
+        g.n = n;
+        g.ownOffset.assign(n + 1, 0);
+        for (const EdgeT& e : edges) {
+            g.ownOffset[e.u + 1]++;
+            g.ownOffset[e.v + 1]++;
+        }
+        for (int i = 0; i < n; i++) g.ownOffset[i + 1] += g.ownOffset[i];
+
+        std::size_t m2 = g.ownOffset[n];
+        g.ownTarget.resize(m2);
+        g.ownWeight.resize(m2);
+        if (keepEdgeIds) g.ownEdgeId.resize(m2);
+        std::vector<std::size_t> fill(g.ownOffset.begin(), g.ownOffset.end() - 1);
+        for (std::size_t i = 0; i < edges.size(); i++) {
+            const EdgeT& e = edges[i];
+            std::size_t a = fill[e.u]++, b = fill[e.v]++;
+            g.ownTarget[a] = (Id)e.v;
+            g.ownWeight[a] = e.w;
+            g.ownTarget[b] = (Id)e.u;
+            g.ownWeight[b] = e.w;
+            if (keepEdgeIds) g.ownEdgeId[a] = g.ownEdgeId[b] = (int)i;
+        }
+        g.offset = g.ownOffset.data();
+        g.target = g.ownTarget.data();
+        g.weight = g.ownWeight.data();
+        g.edgeId = keepEdgeIds ? g.ownEdgeId.data() : nullptr;
+        return g;
+    }
+    template <class EdgeT>
+    static CsrGraph build(int n, const std::vector<EdgeT>& edges, bool keepEdgeIds = false) {
+        return build(n, ArrayView<EdgeT>(edges), keepEdgeIds);
+    }
+
+    // wrap arrays owned elsewhere; nothing is copied
+    static CsrGraph view(int n, const std::size_t* offset, const Id* target, const W* weight,
+                         const int* edgeId) {
+        CsrGraph g;
+        g.n = n;
+        g.offset = offset;
+        g.target = target;
+        g.weight = weight;
+        g.edgeId = edgeId;
+        return g;
+    }
+
+private:
+    std::vector<std::size_t> ownOffset;
+    std::vector<Id> ownTarget;
+    std::vector<W> ownWeight;
+    std::vector<int> ownEdgeId;
+};
@@ -0,0 +1,226 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#include "edge_loader.h"
+#include "graph.h"
+
+// Binary graph files, so repeated MST runs on one graph skip text parsing.
+// graph_convert.cpp turns the text edge lists into this format.
+//
+// Layout (native byte order; every section starts 8-byte aligned):
+//
+//   GraphFileHeader                      64 bytes
+//   m edge records {int32 u, v; W w}     16 bytes each, 0-indexed
+//   if hasCsr:
+//     n + 1 uint64 offsets
+//     2m int32 targets
+//     2m W weights
+//     2m int32 input edge ids
+//
+// GraphFile maps the whole file and hands out views into it: loading is an
+// mmap plus a header check, with no per-edge work at all.
+
+enum GraphWeightType : std::uint32_t { WEIGHT_INT64 = 1, WEIGHT_DOUBLE = 2 };
+
+struct GraphFileHeader {
+    char magic[8];  // "MSTGRAPH"
+    std::uint32_t version;
+    std::uint32_t weightType;  // GraphWeightType
+    std::uint64_t n;
+    std::uint64_t m;
+    std::uint32_t hasCsr;
+    std::uint32_t reserved[7];
+};
+static_assert(sizeof(GraphFileHeader) == 64, "GraphFileHeader must stay 64 bytes");
+
+static const char GRAPH_FILE_MAGIC[8] = {'M', 'S', 'T', 'G', 'R', 'A', 'P', 'H'};
+static const std::uint32_t GRAPH_FILE_VERSION = 1;
+
+template <class W>
+constexpr GraphWeightType graphWeightType() {
+    static_assert(std::is_same<W, long long>::value || std::is_same<W, double>::value,
+                  "binary graph files hold long long or double weights");
+    return std::is_same<W, double>::value ? WEIGHT_DOUBLE : WEIGHT_INT64;
+}
+
+// EdgeT must be laid out as {int u; int v; W w;} to be read in place
+template <class EdgeT>
+constexpr bool isPackedEdge() {
+    return std::is_standard_layout<EdgeT>::value && sizeof(EdgeT) == 16 && offsetof(EdgeT, u) == 0 &&
+           offsetof(EdgeT, v) == 4 && offsetof(EdgeT, w) == 8;
+}
+
+// Writes edges (0-indexed) and, if withCsr, the CSR arrays; false on I/O error.
+template <class EdgeT>
+bool writeGraphFile(const char* path, int n, ArrayView<EdgeT> edges, bool withCsr) {
+    using W = decltype(EdgeT::w);
+    static_assert(isPackedEdge<EdgeT>(), "edge records must be {int u, v; 8-byte w}");
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    GraphFileHeader h;
+    std::memset(&h, 0, sizeof h);
+    std::memcpy(h.magic, GRAPH_FILE_MAGIC, sizeof h.magic);
+    h.version = GRAPH_FILE_VERSION;
+    h.weightType = graphWeightType<W>();
+    h.n = (std::uint64_t)n;
+    h.m = edges.size();
+    h.hasCsr = withCsr;
+    bool ok = std::fwrite(&h, sizeof h, 1, f) == 1;
+    ok = ok && std::fwrite(edges.begin(), sizeof(EdgeT), edges.size(), f) == edges.size();
+    if (ok && withCsr) {
+        CsrGraph<W> g = CsrGraph<W>::build(n, edges, true);
+        std::size_t m2 = g.arcs();
+        ok = std::fwrite(g.offset, sizeof(std::size_t), n + 1, f) == (std::size_t)n + 1 &&
+             std::fwrite(g.target, sizeof(int), m2, f) == m2 && std::fwrite(g.weight, sizeof(W), m2, f) == m2 &&
+             std::fwrite(g.edgeId, sizeof(int), m2, f) == m2;
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+class GraphFile {
+public:
+    GraphFile() = default;
+    GraphFile(const GraphFile&) = delete;
+    GraphFile& operator=(const GraphFile&) = delete;
+    ~GraphFile() {
+        if (base) munmap(base, len);
+    }
+
+    // true if `path` starts with the binary magic (cheap; reads 8 bytes)
+    static bool detect(const char* path) {
+        if (path == nullptr) return false;
+        FILE* f = std::fopen(path, "rb");
+        if (!f) return false;
+        char magic[8];
+        bool yes = std::fread(magic, 1, 8, f) == 8 && std::memcmp(magic, GRAPH_FILE_MAGIC, 8) == 0;
+        std::fclose(f);
+        return yes;
+    }
+
+    // maps the file and validates header and size; on failure error() says why
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return fail("cannot open file");
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(GraphFileHeader)) {
+            ::close(fd);
+            return fail("file too small for a graph header");
+        }
+        len = (std::size_t)st.st_size;
+        void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return fail("mmap failed");
+        base = p;
+        const GraphFileHeader& h = header();
+        if (std::memcmp(h.magic, GRAPH_FILE_MAGIC, 8) != 0) return fail("not a binary graph file");
+        if (h.version != GRAPH_FILE_VERSION) return fail("unsupported graph file version");
+        if (h.n > (std::uint64_t)INT32_MAX || h.m > (std::uint64_t)INT32_MAX) return fail("graph too large");
+        std::size_t need = sizeof(GraphFileHeader) + h.m * 16;
+        if (h.hasCsr) need += (h.n + 1) * 8 + 2 * h.m * (4 + 8 + 4);
+        if (len < need) return fail("file is truncated");
+        return true;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    const GraphFileHeader& header() const { return *static_cast<const GraphFileHeader*>(base); }
+    int n() const { return (int)header().n; }
+    bool hasCsr() const { return header().hasCsr != 0; }
+    const std::string& error() const { return err; }
+
+    // the edge records, in place; EdgeT's weight type must match the file
+    template <class EdgeT>
+    bool edges(ArrayView<EdgeT>& out) {
+        static_assert(isPackedEdge<EdgeT>(), "edge records must be {int u, v; 8-byte w}");
+        if (header().weightType != graphWeightType<decltype(EdgeT::w)>()) return fail("weight type mismatch");
+        out = ArrayView<EdgeT>(reinterpret_cast<const EdgeT*>(section(0)), header().m);
+        return true;
+    }
+
+    // the stored CSR, in place (with edge ids); requires hasCsr()
+    template <class W>
+    bool csr(CsrGraph<W>& out) {
+        if (!hasCsr()) return fail("file has no CSR section");
+        if (header().weightType != graphWeightType<W>()) return fail("weight type mismatch");
+        std::size_t n = header().n, m2 = 2 * header().m;
+        const char* p = section(header().m * 16);
+        const std::size_t* offset = reinterpret_cast<const std::size_t*>(p);
+        const int* target = reinterpret_cast<const int*>(p + (n + 1) * 8);
+        const W* weight = reinterpret_cast<const W*>(p + (n + 1) * 8 + m2 * 4);
+        const int* edgeId = reinterpret_cast<const int*>(p + (n + 1) * 8 + m2 * 12);
+        out = CsrGraph<W>::view((int)n, offset, target, weight, edgeId);
+        return true;
+    }
+
+private:
+    void* base = nullptr;
+    std::size_t len = 0;
+    std::string err;
+
+    const char* section(std::size_t at) const {
+        return static_cast<const char*>(base) + sizeof(GraphFileHeader) + at;
+    }
+    bool fail(const char* why) {
+        err = why;
+        return false;
+    }
+};
+
+// An input graph in either format: binary files (recognised by their magic)
+// are mapped and used in place, anything else goes through the text loader
+// with vertex ids `textBase`-indexed. The CSR comes from the file when it
+// has one, otherwise it is built here.
+template <class EdgeT, class W = decltype(EdgeT::w)>
+struct LoadedGraph {
+    int n = 0;
+    ArrayView<EdgeT> edges;
+    CsrGraph<W> g;
+    std::string error;
+
+    bool load(const char* path, int textBase, bool keepEdgeIds) {
+        if (!loadEdges(path, textBase)) return false;
+        if (bin.isOpen() && bin.hasCsr()) {
+            if (!bin.csr(g)) {
+                error = bin.error();
+                return false;
+            }
+            return true;
+        }
+        g = CsrGraph<W>::build(n, edges, keepEdgeIds);
+        return true;
+    }
+
+    // just n and the edges, for engines that never look at adjacency
+    bool loadEdges(const char* path, int textBase) {
+        if (GraphFile::detect(path)) {
+            if (!bin.open(path) || !bin.edges(edges)) {
+                error = bin.error();
+                return false;
+            }
+            n = bin.n();
+            return true;
+        }
+        if (!loadEdgeList(path, n, storage, textBase, &error)) return false;
+        edges = storage;
+        return true;
+    }
+
+    // for callers that only need the CSR afterwards
+    void dropEdges() {
+        edges = ArrayView<EdgeT>();
+        std::vector<EdgeT>().swap(storage);
+    }
+
+private:
+    GraphFile bin;
+    std::vector<EdgeT> storage;
+};
@@ -0,0 +1,50 @@
+// Converts a text edge list into the binary graph format of graph_binary.h.
+//
+//   graph_convert [--double] [--base=0|1] [--csr] input.txt output.bin
+//
+// --double    weights are doubles (Fredman-Tarjan input); default long long
+// --base=B    vertex ids in the text are B-indexed; default 1, or 0 with
+//             --double, matching what each MST program reads
+// --csr       also store the CSR arrays, so loaders skip building them
+#include <bits/stdc++.h>
+#include "edge_loader.h"
+#include "graph_binary.h"
+using namespace std;
+
+template <class W>
+int convert(const char* in, const char* out, int base, bool csr) {
+    int n;
+    vector<WeightedEdge<W>> edges;
+    string error;
+    if (!loadEdgeList(in, n, edges, base, &error)) {
+        cerr << in << ": " << error;
+        if (error.rfind("vertex id", 0) == 0) cerr << " (wrong --base?)";
+        cerr << "\n";
+        return 1;
+    }
+    if (!writeGraphFile(out, n, ArrayView<WeightedEdge<W>>(edges), csr)) {
+        cerr << out << ": write failed\n";
+        return 1;
+    }
+    cerr << "wrote " << out << ": n=" << n << " m=" << edges.size() << (csr ? " with CSR" : "") << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    bool dbl = false, csr = false;
+    int base = -1;
+    vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--double") dbl = true;
+        else if (arg == "--csr") csr = true;
+        else if (arg.rfind("--base=", 0) == 0) base = atoi(arg.c_str() + 7);
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2) {
+        cerr << "usage: " << argv[0] << " [--double] [--base=0|1] [--csr] input.txt output.bin\n";
+        return 2;
+    }
+    if (base < 0) base = dbl ? 0 : 1;
+    return dbl ? convert<double>(files[0], files[1], base, csr) : convert<long long>(files[0], files[1], base, csr);
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Batched queue updates for the engines templated on the heap (primMST,
+// Fredman-Tarjan's growTrees). While scanning one vertex's arcs, the engine
+// hands every insert and decrease_key to a HeapBatch instead of the heap,
+// and calls flush() once the scan is done:
+//
+//   HeapBatch<Heap> batch;
+//   batch.begin(arcs);                    // size of the scan about to be made
+//   batch.insert(H, key, v, node[v]);     // node[v] is set by flush() at the latest
+//   batch.decrease_key(H, node[v], key);  // key must be smaller than v's current one
+//   batch.flush(H);
+//
+// The heap is an argument rather than a member so one batch, and its
+// buffers, can serve a run's many short-lived heaps (one per tree in
+// Fredman-Tarjan).
+//
+// For a heap with bulk operations (FibHeap: insert_range, decrease_keys)
+// the scan's new vertices then join the root list in one splice, and its
+// decreases are cut together with one minimum update. Any other heap gets
+// the plain per-element calls as they come, so nothing is buffered. So do
+// scans of fewer than BATCH_MIN arcs: with only a couple of updates the
+// buffering costs more than the shared splice and minimum update save
+// (Fredman-Tarjan on a sparse graph ran about 20% slower batching every
+// scan).
+
+template <class Heap, class = void>
+struct HasBatchOps : std::false_type {};
+template <class Heap>
+struct HasBatchOps<Heap, decltype(std::declval<Heap&>().decrease_keys(
+                                      (std::pair<typename Heap::handle, decltype(Heap::Entry::key)>*)nullptr,
+                                      (std::pair<typename Heap::handle, decltype(Heap::Entry::key)>*)nullptr),
+                                  void())> : std::true_type {};
+
+template <class Heap, bool = HasBatchOps<Heap>::value>
+class HeapBatch {
+public:
+    using handle = typename Heap::handle;
+
+    void begin(std::size_t) {}
+    template <class Key, class Payload>
+    void insert(Heap& H, const Key& key, Payload payload, handle& slot) {
+        slot = H.insert(key, std::move(payload));
+    }
+    template <class Key>
+    void decrease_key(Heap& H, handle& slot, const Key& key) {
+        H.decrease_key(slot, key);
+    }
+    void flush(Heap&) {}
+};
+
+template <class Heap>
+class HeapBatch<Heap, true> {
+public:
+    using handle = typename Heap::handle;
+    using Entry = typename Heap::Entry;
+    using Key = decltype(Entry::key);
+    static_assert(std::is_pointer<handle>::value && alignof(typename std::remove_pointer<handle>::type) > 1,
+                  "pending slots are tagged pointers");
+
+    static constexpr std::size_t BATCH_MIN = 8;
+
+    // the updates of a scan of fewer than BATCH_MIN arcs go straight to the
+    // heap; the previous scan must have been flushed
+    void begin(std::size_t arcs) { direct = arcs < BATCH_MIN; }
+
+    // Until the inserts are flushed, slot holds the element's index in the
+    // batch, tagged with the low bit no real (aligned) handle has, so a
+    // parallel arc finds its pending entry in O(1).
+    template <class Payload>
+    void insert(Heap& H, const Key& key, Payload payload, handle& slot) {
+        if (direct) {
+            slot = H.insert(key, std::move(payload));
+            return;
+        }
+        if (fresh.size() == CAPACITY) flushInserts(H);
+        slot = reinterpret_cast<handle>(fresh.size() << 1 | 1);
+        fresh.push_back(Entry{key, std::move(payload)});
+        slots.push_back(&slot);
+    }
+
+    void decrease_key(Heap& H, handle& slot, const Key& key) {
+        if (direct) {
+            H.decrease_key(slot, key);
+            return;
+        }
+        std::uintptr_t tag = reinterpret_cast<std::uintptr_t>(slot);
+        if (tag & 1) {
+            // inserted in this batch (a parallel arc): lower the pending key
+            fresh[tag >> 1].key = key;
+            return;
+        }
+        lowered.emplace_back(slot, key);
+    }
+
+    void flush(Heap& H) {
+        flushInserts(H);
+        if (!lowered.empty()) {
+            H.decrease_keys(lowered.begin(), lowered.end());
+            lowered.clear();
+        }
+    }
+
+private:
+    // inserts are passed on in chunks of at most this many, so a bulk load
+    // like Prim's eager start does not buffer a copy of everything
+    static constexpr std::size_t CAPACITY = 1024;
+
+    bool direct = false;
+    std::vector<Entry> fresh;
+    std::vector<handle*> slots;  // where each fresh element's handle goes
+    std::vector<handle> handles;
+    std::vector<std::pair<handle, Key>> lowered;
+
+    void flushInserts(Heap& H) {
+        if (fresh.empty()) return;
+        handles.resize(fresh.size());
+        H.insert_range(fresh.begin(), fresh.end(), handles.data());
+        for (std::size_t i = 0; i < fresh.size(); i++) *slots[i] = handles[i];
+        fresh.clear();
+        slots.clear();
+    }
+};
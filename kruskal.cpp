@@ -0,0 +1,52 @@
+#include <bits/stdc++.h>
+#include "graph_binary.h"
+#include "kruskal.h"
+#include "output_writer.h"
+#include "thread_pool.h"
+using namespace std;
+
+// ---- Filter-Kruskal ----
+// Same input and output as prims_using_fib, so the engines can be swapped.
+// --threads=N   parallel partition / filter on N threads (0: all cores)
+// --binary-out  write the tree as an edge index list
+// [input]       text edge list (1-indexed) or binary graph file
+//               (default: text on stdin)
+// Disconnected input yields a minimum spanning forest.
+int main(int argc, char** argv) {
+    bool binaryOut = false;
+    int threads = -1;
+    const char* input = nullptr;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--binary-out") binaryOut = true;
+        else if (arg.rfind("--threads=", 0) == 0) threads = atoi(arg.c_str() + 10);
+        else input = argv[i];
+    }
+    // no adjacency needed: just the edge records
+    LoadedGraph<WeightedEdge<long long>> in;
+    if (!in.loadEdges(input, 1)) {
+        cerr << (input ? input : "stdin") << ": " << in.error << "\n";
+        return 1;
+    }
+    int n = in.n;
+    ArrayView<WeightedEdge<long long>> edges = in.edges;
+
+    KruskalResult<long long> r;
+    if (threads >= 0) {
+        ThreadPool pool(threads);
+        r = filterKruskalMST(n, edges, &pool);
+    } else {
+        r = filterKruskalMST(n, edges);
+    }
+
+    BufferedWriter out;
+    if (binaryOut) {
+        writeEdgeIndexList(out, r.edges);
+        return 0;
+    }
+    out << "Total MST weight: " << r.totalWeight << "\n";
+    if (r.trees > 1) out << "Graph is disconnected: spanning forest of " << r.trees << " trees\n";
+    out << "Edges in MST:\n";
+    for (int id : r.edges) out << edges[id].u + 1 << ' ' << edges[id].v + 1 << ' ' << edges[id].w << '\n';
+    return 0;
+}
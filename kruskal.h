@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "dsu.h"
+#include "graph.h"
+#include "radix_sort.h"
+#include "thread_pool.h"
+
+// Filter-Kruskal (Osipov, Sanders, Singler): quicksort on the edge weights,
+// except that before the heavy half is recursed into, every edge whose ends
+// are already connected by the light half is filtered out. On sparse graphs
+// most heavy edges die in a filter pass and are never sorted at all.
+//
+//   filterKruskal(E):
+//     if E is small: radix sort E, plain Kruskal
+//     else:          split E at a random pivot into E<= and E>
+//                    filterKruskal(E<=)
+//                    filterKruskal(filter(E>))
+//
+// Edges are ordered by (weight, input index), so the result is the same
+// forest whatever the pivots or thread count. With a ThreadPool, partitions
+// and filters of large ranges run in parallel (per-thread counts, prefix
+// sum, scatter), using the lock-free ConcurrentDSU for the filter's finds;
+// the base-case unions stay serial. Works on any EdgeT with members u, v, w
+// (0-indexed).
+
+template <class W>
+struct KruskalResult {
+    W totalWeight = W();
+    std::vector<int> edges;  // input edge indices, in nondecreasing weight order
+    int trees = 0;           // > 1 when the graph is disconnected
+};
+
+template <class W>
+struct KruskalEdge {
+    int u, v;
+    W w;
+    int id;
+};
+
+template <class W>
+inline bool kruskalLess(const KruskalEdge<W>& a, const KruskalEdge<W>& b) {
+    return a.w < b.w || (a.w == b.w && a.id < b.id);
+}
+
+template <class W, class DSUType>
+class FilterKruskal {
+public:
+    FilterKruskal(int n, std::vector<KruskalEdge<W>>& edges, DSUType& dsu, ThreadPool* pool)
+        : E(edges), dsu(dsu), pool(pool), rng(1), components(n) {
+        if (pool && pool->size() > 1) tmp.resize(E.size());
+    }
+
+    void run(std::vector<int>& out) {
+        mst = &out;
+        solve(0, E.size());
+    }
+
+private:
+    // below this many edges: sort and scan; above it with a pool: go parallel
+    static const std::size_t BASE = 1 << 10, PARALLEL = 1 << 16;
+
+    std::vector<KruskalEdge<W>>& E;
+    std::vector<KruskalEdge<W>> tmp, scratch;
+    DSUType& dsu;
+    ThreadPool* pool;
+    std::mt19937_64 rng;
+    int components;
+    std::vector<int>* mst;
+
+    void solve(std::size_t lo, std::size_t hi) {
+        while (components > 1 && hi > lo) {
+            if (hi - lo <= BASE) {
+                kruskal(lo, hi);
+                return;
+            }
+            KruskalEdge<W> pivot = choosePivot(lo, hi);
+            std::size_t mid = split(lo, hi, [&](const KruskalEdge<W>& e) { return !kruskalLess(pivot, e); });
+            // the pivot was the largest edge, so the light side is the whole
+            // range: split off the pivot alone instead (a three-way split;
+            // edges are distinct under kruskalLess) so the recursion shrinks
+            if (mid == hi) mid = split(lo, hi, [&](const KruskalEdge<W>& e) { return kruskalLess(e, pivot); });
+            solve(lo, mid);
+            lo = mid;
+            hi = split(lo, hi, [&](const KruskalEdge<W>& e) { return dsu.find(e.u) != dsu.find(e.v); });
+        }
+    }
+
+    void kruskal(std::size_t lo, std::size_t hi) {
+        sortRange(lo, hi);
+        for (std::size_t i = lo; i < hi && components > 1; i++) {
+            if (dsu.find(E[i].u) == dsu.find(E[i].v)) continue;
+            dsu.unite(E[i].u, E[i].v);
+            mst->push_back(E[i].id);
+            components--;
+        }
+    }
+
+    // radix sort by weight, then order each run of equal weights by id (the
+    // partitions leave them in no particular order)
+    void sortRange(std::size_t lo, std::size_t hi) {
+        scratch.resize(std::max(scratch.size(), hi - lo));
+        radixSort(E.data() + lo, scratch.data(), hi - lo, [](const KruskalEdge<W>& e) { return radixKey(e.w); });
+        for (std::size_t i = lo, j; i < hi; i = j) {
+            for (j = i + 1; j < hi && E[j].w == E[i].w;) j++;
+            if (j - i > 1)
+                std::sort(E.begin() + i, E.begin() + j,
+                          [](const KruskalEdge<W>& a, const KruskalEdge<W>& b) { return a.id < b.id; });
+        }
+    }
+
+    // median of three random edges
+    KruskalEdge<W> choosePivot(std::size_t lo, std::size_t hi) {
+        KruskalEdge<W> a = E[lo + rng() % (hi - lo)], b = E[lo + rng() % (hi - lo)], c = E[lo + rng() % (hi - lo)];
+        if (kruskalLess(b, a)) std::swap(a, b);
+        if (kruskalLess(c, b)) std::swap(b, c);
+        if (kruskalLess(b, a)) std::swap(a, b);
+        return b;
+    }
+
+    // moves the edges with keep(e) to the front of [lo, hi), returns where
+    // they end; the others follow (and are dropped by the filter's caller)
+    template <class Keep>
+    std::size_t split(std::size_t lo, std::size_t hi, Keep keep) {
+        if (!pool || pool->size() == 1 || hi - lo < PARALLEL)
+            return std::partition(E.begin() + lo, E.begin() + hi, keep) - E.begin();
+
+        unsigned T = pool->size();
+        std::size_t n = hi - lo;
+        std::vector<std::size_t> left(T + 1, 0), right(T + 1, 0);
+        pool->for_chunks(n, [&](unsigned t, std::size_t a, std::size_t b) {
+            std::size_t k = 0;
+            for (std::size_t i = lo + a; i < lo + b; i++) k += keep(E[i]);
+            left[t + 1] = k;
+            right[t + 1] = (b - a) - k;
+        });
+        for (unsigned t = 0; t < T; t++) {
+            left[t + 1] += left[t];
+            right[t + 1] += right[t];
+        }
+        std::size_t mid = left[T];
+        pool->for_chunks(n, [&](unsigned t, std::size_t a, std::size_t b) {
+            std::size_t l = lo + left[t], r = lo + mid + right[t];
+            for (std::size_t i = lo + a; i < lo + b; i++) tmp[keep(E[i]) ? l++ : r++] = E[i];
+        });
+        pool->for_chunks(n, [&](unsigned, std::size_t a, std::size_t b) {
+            std::copy(tmp.begin() + lo + a, tmp.begin() + lo + b, E.begin() + lo + a);
+        });
+        return lo + mid;
+    }
+};
+
+// Minimum spanning forest; pool == nullptr (or a pool of one) runs serially
+// with the rank-based DSU.
+template <class EdgeT, class W = decltype(EdgeT::w)>
+KruskalResult<W> filterKruskalMST(int n, ArrayView<EdgeT> input, ThreadPool* pool = nullptr) {
+    std::vector<KruskalEdge<W>> edges(input.size());
+    auto load = [&](std::size_t a, std::size_t b) {
+        for (std::size_t i = a; i < b; i++) edges[i] = KruskalEdge<W>{input[i].u, input[i].v, input[i].w, (int)i};
+    };
+    if (pool) pool->for_chunks(input.size(), [&](unsigned, std::size_t a, std::size_t b) { load(a, b); });
+    else load(0, input.size());
+
+    KruskalResult<W> r;
+    if (pool && pool->size() > 1) {
+        ConcurrentDSU dsu(n);
+        FilterKruskal<W, ConcurrentDSU>(n, edges, dsu, pool).run(r.edges);
+    } else {
+        DSU dsu(n);
+        FilterKruskal<W, DSU>(n, edges, dsu, nullptr).run(r.edges);
+    }
+    for (int id : r.edges) r.totalWeight += input[id].w;
+    r.trees = n - (int)r.edges.size();
+    return r;
+}
@@ -0,0 +1,86 @@
+// Input throughput: the old `cin >>` path against loadEdgeList (mmap + hand
+// parser), for integer weights (Prim / Boruvka input) and double weights
+// (Fredman-Tarjan input).
+//
+//   g++ -O2 -std=c++17 loader_bench.cpp -o loader_bench
+//   ./loader_bench [m] [scratch_dir]
+//
+// Writes two m-edge files into scratch_dir (default /tmp), then reports
+// MB/s for each reader, best of three.
+#include <bits/stdc++.h>
+#include "edge_loader.h"
+#include "graph.h"
+using namespace std;
+
+template <class W>
+static void writeFile(const string& path, int n, long long m) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        perror(path.c_str());
+        exit(1);
+    }
+    mt19937_64 rng(3);
+    fprintf(f, "%d %lld\n", n, m);
+    for (long long i = 0; i < m; i++) {
+        int u = (int)(rng() % n) + 1, v = (int)(rng() % n) + 1;
+        if (is_integral<W>::value) fprintf(f, "%d %d %llu\n", u, v, (unsigned long long)(rng() % 1000000000));
+        else fprintf(f, "%d %d %.4f\n", u, v, (double)(rng() % 100000000) / 1e4);
+    }
+    fclose(f);
+}
+
+// what the drivers used to do
+template <class W>
+static bool readWithCin(const string& path, int& n, vector<WeightedEdge<W>>& edges) {
+    if (!freopen(path.c_str(), "r", stdin)) return false;
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+    cin.clear();
+    long long m;
+    if (!(cin >> n >> m)) return false;
+    edges.resize(m);
+    for (auto& e : edges) {
+        cin >> e.u >> e.v >> e.w;
+        --e.u;
+        --e.v;
+    }
+    return (bool)cin;
+}
+
+template <class W>
+static void bench(const char* label, const string& path) {
+    double mb = (double)filesystem::file_size(path) / 1e6;
+    double best[2] = {1e18, 1e18};
+    W check[2] = {0, 0};
+    for (int r = 0; r < 3; r++) {
+        for (int which = 0; which < 2; which++) {
+            int n;
+            vector<WeightedEdge<W>> edges;
+            auto t0 = chrono::steady_clock::now();
+            bool ok = which == 0 ? readWithCin(path, n, edges) : loadEdgeList(path.c_str(), n, edges, 1);
+            double s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            if (!ok) {
+                fprintf(stderr, "read failed: %s\n", path.c_str());
+                exit(1);
+            }
+            best[which] = min(best[which], s);
+            check[which] = edges.empty() ? W() : edges.back().w;
+        }
+    }
+    printf("%-8s %8.1f MB   cin %8.1f MB/s   mmap %8.1f MB/s   speedup %5.1fx%s\n", label, mb, mb / best[0],
+           mb / best[1], best[0] / best[1], check[0] == check[1] ? "" : "  MISMATCH");
+}
+
+int main(int argc, char** argv) {
+    long long m = argc > 1 ? atoll(argv[1]) : 5000000;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+    int n = (int)max(2LL, m / 8);
+    string intPath = dir + "/loader_bench_int.txt", dblPath = dir + "/loader_bench_double.txt";
+    writeFile<long long>(intPath, n, m);
+    writeFile<double>(dblPath, n, m);
+    bench<long long>("int", intPath);
+    bench<double>("double", dblPath);
+    remove(intPath.c_str());
+    remove(dblPath.c_str());
+    return 0;
+}
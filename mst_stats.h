@@ -0,0 +1,234 @@
+#pragma once
+
+// Operation counters for the MST building blocks: FibHeap, CompactFibHeap,
+// DSU and ConcurrentDSU. They exist to line real runs up against the
+// amortized analysis: how many links and cuts a run made, how long the root
+// lists were when consolidate() walked them, and how long the DSU find
+// paths were.
+//
+// Compiled in only with -DMST_STATS, e.g.
+//
+//   g++ -O2 -std=c++17 -DMST_STATS fredma_tarjan.cpp -o fredma_tarjan_stats
+//
+// Without it every MST_STAT_* macro expands to nothing, and not even its
+// arguments are evaluated. With it, each thread counts into its own
+// thread_local Totals, merged when the thread exits. At program exit the
+// sum is written as one JSON object to the file named by $MST_STATS_FILE,
+// or to stderr when that is unset, so stdout stays the program's output.
+//
+// Counters and distributions are exact. Latencies come from two
+// steady_clock reads per timed call, so calls that take a few nanoseconds
+// (a DSU find) get their clock overhead added. Nested calls are timed on
+// their own and again inside the caller (find inside unite, extract_min
+// inside erase).
+
+#ifdef MST_STATS
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+namespace mst_stats {
+
+// count, sum and max of a non-negative quantity, and a log2 histogram:
+// bucket 0 holds the zeros, bucket i > 0 the values in [2^(i-1), 2^i)
+struct Histogram {
+    static constexpr int BUCKETS = 65;
+    std::uint64_t count = 0, sum = 0, max = 0;
+    std::uint64_t bucket[BUCKETS] = {};
+
+    void add(std::uint64_t v) {
+        count++;
+        sum += v;
+        if (v > max) max = v;
+        bucket[v == 0 ? 0 : 64 - __builtin_clzll(v)]++;
+    }
+
+    void merge(const Histogram& o) {
+        count += o.count;
+        sum += o.sum;
+        if (o.max > max) max = o.max;
+        for (int i = 0; i < BUCKETS; i++) bucket[i] += o.bucket[i];
+    }
+
+    void write(std::FILE* f) const {
+        int top = BUCKETS;
+        while (top > 0 && bucket[top - 1] == 0) top--;
+        std::fprintf(f, "{\"count\": %llu, \"sum\": %llu, \"max\": %llu, \"mean\": %.3f, \"log2\": [",
+                     (unsigned long long)count, (unsigned long long)sum, (unsigned long long)max,
+                     count ? (double)sum / count : 0.0);
+        for (int i = 0; i < top; i++) std::fprintf(f, "%s%llu", i ? ", " : "", (unsigned long long)bucket[i]);
+        std::fprintf(f, "]}");
+    }
+};
+
+// one per heap type; latencies in nanoseconds
+struct HeapTotals {
+    Histogram insert, insert_range, extract_min, decrease_key, decrease_keys, meld, erase;
+    std::uint64_t links = 0;           // trees joined by consolidate()
+    std::uint64_t cuts = 0;            // nodes moved to the root list, cascading ones included
+    std::uint64_t cascading_cuts = 0;  // cuts of marked parents
+    std::uint64_t marks = 0;           // parents marked on losing a first child
+    Histogram root_list;               // roots walked by each consolidate()
+    Histogram max_degree;              // highest root degree after each consolidate()
+
+    void merge(const HeapTotals& o) {
+        insert.merge(o.insert);
+        insert_range.merge(o.insert_range);
+        extract_min.merge(o.extract_min);
+        decrease_key.merge(o.decrease_key);
+        decrease_keys.merge(o.decrease_keys);
+        meld.merge(o.meld);
+        erase.merge(o.erase);
+        links += o.links;
+        cuts += o.cuts;
+        cascading_cuts += o.cascading_cuts;
+        marks += o.marks;
+        root_list.merge(o.root_list);
+        max_degree.merge(o.max_degree);
+    }
+
+    void write(std::FILE* f) const {
+        const Histogram* op[] = {&insert, &insert_range, &extract_min, &decrease_key, &decrease_keys, &meld, &erase};
+        const char* name[] = {"insert", "insert_range", "extract_min", "decrease_key", "decrease_keys", "meld", "erase"};
+        std::fprintf(f, "{\"latency_ns\": {");
+        for (int i = 0; i < 7; i++) {
+            std::fprintf(f, "%s\n      \"%s\": ", i ? "," : "", name[i]);
+            op[i]->write(f);
+        }
+        std::fprintf(f, "},\n    \"links\": %llu, \"cuts\": %llu, \"cascading_cuts\": %llu, \"marks\": %llu,",
+                     (unsigned long long)links, (unsigned long long)cuts, (unsigned long long)cascading_cuts,
+                     (unsigned long long)marks);
+        std::fprintf(f, "\n    \"root_list\": ");
+        root_list.write(f);
+        std::fprintf(f, ",\n    \"max_degree\": ");
+        max_degree.write(f);
+        std::fprintf(f, "}");
+    }
+};
+
+// one per union-find type; latencies in nanoseconds
+struct DsuTotals {
+    Histogram find, unite;
+    Histogram path;                  // parent steps taken by each find
+    std::uint64_t cas_failures = 0;  // ConcurrentDSU: path-halving CAS that lost a race
+    std::uint64_t unite_retries = 0;  // ConcurrentDSU: links redone after a concurrent one
+
+    void merge(const DsuTotals& o) {
+        find.merge(o.find);
+        unite.merge(o.unite);
+        path.merge(o.path);
+        cas_failures += o.cas_failures;
+        unite_retries += o.unite_retries;
+    }
+
+    void write(std::FILE* f) const {
+        std::fprintf(f, "{\"latency_ns\": {\n      \"find\": ");
+        find.write(f);
+        std::fprintf(f, ",\n      \"unite\": ");
+        unite.write(f);
+        std::fprintf(f, "},\n    \"path\": ");
+        path.write(f);
+        std::fprintf(f, ",\n    \"cas_failures\": %llu, \"unite_retries\": %llu}", (unsigned long long)cas_failures,
+                     (unsigned long long)unite_retries);
+    }
+};
+
+struct Totals {
+    HeapTotals fib, compact_fib;
+    DsuTotals dsu, concurrent_dsu;
+
+    void merge(const Totals& o) {
+        fib.merge(o.fib);
+        compact_fib.merge(o.compact_fib);
+        dsu.merge(o.dsu);
+        concurrent_dsu.merge(o.concurrent_dsu);
+    }
+
+    void write(std::FILE* f) const {
+        std::fprintf(f, "{\n  \"fib_heap\": ");
+        fib.write(f);
+        std::fprintf(f, ",\n  \"compact_fib_heap\": ");
+        compact_fib.write(f);
+        std::fprintf(f, ",\n  \"dsu\": ");
+        dsu.write(f);
+        std::fprintf(f, ",\n  \"concurrent_dsu\": ");
+        concurrent_dsu.write(f);
+        std::fprintf(f, "\n}\n");
+    }
+};
+
+// the sum over finished threads, written out when the program exits
+struct Registry {
+    std::mutex lock;
+    Totals sum;
+
+    ~Registry() {
+        const char* path = std::getenv("MST_STATS_FILE");
+        std::FILE* f = path != nullptr ? std::fopen(path, "w") : stderr;
+        if (f == nullptr) {
+            std::fprintf(stderr, "mst_stats: cannot open %s\n", path);
+            return;
+        }
+        sum.write(f);
+        if (f != stderr) std::fclose(f);
+    }
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// A thread's own counters. Constructing the registry first makes it
+// outlive every thread's Local, and thread_locals (the main thread's
+// included) are destroyed before function-local statics.
+struct Local {
+    Totals totals;
+
+    Local() { registry(); }
+    ~Local() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> g(r.lock);
+        r.sum.merge(totals);
+    }
+};
+
+inline Totals& local() {
+    static thread_local Local l;
+    return l.totals;
+}
+
+// adds the lifetime of the enclosing scope to a latency histogram
+class Timer {
+public:
+    explicit Timer(Histogram& h) : h(h), start(std::chrono::steady_clock::now()) {}
+    ~Timer() {
+        h.add((std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                  .count());
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+private:
+    Histogram& h;
+    std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace mst_stats
+
+// field is a path into Totals, e.g. fib.links or dsu.path
+#define MST_STAT_COUNT(field) (++::mst_stats::local().field)
+#define MST_STAT_SAMPLE(field, value) (::mst_stats::local().field.add((std::uint64_t)(value)))
+#define MST_STAT_TIME(field) ::mst_stats::Timer mst_stat_timer_(::mst_stats::local().field)
+
+#else
+
+#define MST_STAT_COUNT(field) ((void)0)
+#define MST_STAT_SAMPLE(field, value) ((void)sizeof(value))
+#define MST_STAT_TIME(field) ((void)0)
+
+#endif
@@ -0,0 +1,156 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+// Slab allocator for heap nodes.
+//
+// Nodes are carved out of large contiguous slabs, so a heap that inserts
+// millions of elements costs a handful of mallocs instead of one per node.
+// destroy() pushes the slot onto a free list that create() serves first.
+// reset() forgets every node in O(#slabs) but keeps the slabs, so the next
+// run on the same pool allocates nothing; only trivially destructible nodes
+// may be dropped that way (nobody runs their destructors).
+template <class T>
+class NodePool {
+public:
+    struct Stats {
+        std::size_t slab_allocs = 0;     // calls to operator new
+        std::size_t bytes_reserved = 0;  // total slab capacity in bytes
+        std::size_t created = 0;         // create() calls
+        std::size_t recycled = 0;        // of those, served from the free list
+        std::size_t live = 0;            // created and not yet destroyed
+
+        friend std::ostream& operator<<(std::ostream& os, const Stats& s) {
+            return os << "nodes created " << s.created << " (recycled " << s.recycled << "), live "
+                      << s.live << ", slab allocations " << s.slab_allocs << ", bytes reserved "
+                      << s.bytes_reserved;
+        }
+    };
+
+    NodePool() = default;
+    ~NodePool() { release(); }
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // make sure the next `count` creates need no further slab allocation
+    void reserve(std::size_t count) {
+        std::size_t avail = (std::size_t)(end - bump);
+        for (std::size_t i = cur + 1; i < slabs.size(); ++i) avail += slabs[i].size;
+        if (avail < count) add_slab(count - avail);
+    }
+
+    template <class... Args>
+    T* create(Args&&... args) {
+        Slot* s;
+        if (free_list != nullptr) {
+            s = free_list;
+            free_list = free_list->next;
+            ++st.recycled;
+        } else {
+            if (bump == end) next_slab();
+            s = bump++;
+        }
+        ++st.created;
+        ++st.live;
+        return ::new (static_cast<void*>(s->storage)) T{std::forward<Args>(args)...};
+    }
+
+    void destroy(T* p) {
+        p->~T();
+        Slot* s = reinterpret_cast<Slot*>(p);
+        s->next = free_list;
+        free_list = s;
+        --st.live;
+    }
+
+    // drop every node at once; the slabs stay around for reuse
+    void reset() {
+        free_list = nullptr;
+        cur = 0;
+        bump = end = nullptr;
+        if (!slabs.empty()) {
+            bump = slabs[0].begin;
+            end = slabs[0].begin + slabs[0].size;
+        }
+        st.live = 0;
+    }
+
+    // give the memory back to the system
+    void release() {
+        for (Slab& s : slabs) delete[] s.begin;
+        slabs.clear();
+        reset();
+    }
+
+    // take ownership of another pool's slabs (used when melding heaps that
+    // were built on different pools); other's free slots come back on reset()
+    void adopt(NodePool& other) {
+        if (&other == this || other.slabs.empty()) return;
+        bool had_slab = !slabs.empty();
+        // other's slabs count as fully used, so they go in front of `cur`
+        slabs.insert(slabs.begin() + (std::ptrdiff_t)cur, other.slabs.begin(), other.slabs.end());
+        if (had_slab) {
+            cur += other.slabs.size();
+        } else {
+            cur = slabs.size() - 1;
+            bump = end = slabs[cur].begin + slabs[cur].size;
+        }
+        st.slab_allocs += other.st.slab_allocs;
+        st.bytes_reserved += other.st.bytes_reserved;
+        st.live += other.st.live;
+        other.slabs.clear();
+        other.st = Stats();
+        other.reset();
+    }
+
+    const Stats& stats() const { return st; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    struct Slab {
+        Slot* begin;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t kFirstSlab = 256;
+    static constexpr std::size_t kMaxSlab = std::size_t(1) << 16;
+
+    std::vector<Slab> slabs;
+    std::size_t cur = 0;     // slab that bump points into
+    Slot* bump = nullptr;
+    Slot* end = nullptr;
+    Slot* free_list = nullptr;
+    Stats st;
+
+    // move on to the next slab, reusing one kept by reset() if there is one
+    void next_slab() {
+        if (bump != nullptr && cur + 1 < slabs.size()) {
+            ++cur;
+        } else {
+            std::size_t last = slabs.empty() ? 0 : slabs.back().size;
+            std::size_t size = last == 0 ? kFirstSlab : std::min(last * 2, kMaxSlab);
+            add_slab(size);
+            cur = slabs.size() - 1;
+        }
+        bump = slabs[cur].begin;
+        end = bump + slabs[cur].size;
+    }
+
+    void add_slab(std::size_t size) {
+        slabs.push_back({new Slot[size], size});
+        ++st.slab_allocs;
+        st.bytes_reserved += size * sizeof(Slot);
+        if (bump == nullptr) {
+            cur = slabs.size() - 1;
+            bump = slabs[cur].begin;
+            end = bump + size;
+        }
+    }
+};
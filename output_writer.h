@@ -0,0 +1,132 @@
+#pragma once
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+// Buffered output for the MST programs' edge lists.
+//
+// Everything goes into one large buffer that is handed to write(2) only
+// when full (and on flush / destruction), so a million-edge forest costs a
+// few dozen syscalls instead of a stream operation per token. Integers are
+// formatted by hand; doubles use std::to_chars with 6 significant digits,
+// which prints exactly what `cout << x` does with default settings, so the
+// programs' output is unchanged byte for byte.
+class BufferedWriter {
+public:
+    explicit BufferedWriter(int fd = 1, std::size_t capacity = 1 << 20) : fd(fd), buf(capacity), pos(0) {}
+    ~BufferedWriter() { flush(); }
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void write(const void* data, std::size_t n) {
+        const char* p = static_cast<const char*>(data);
+        if (n > buf.size() - pos) {
+            flush();
+            if (n >= buf.size()) {
+                write_fd(p, n);
+                return;
+            }
+        }
+        std::memcpy(buf.data() + pos, p, n);
+        pos += n;
+    }
+
+    BufferedWriter& operator<<(char c) {
+        if (pos == buf.size()) flush();
+        buf[pos++] = c;
+        return *this;
+    }
+    BufferedWriter& operator<<(const char* s) {
+        write(s, std::strlen(s));
+        return *this;
+    }
+    BufferedWriter& operator<<(const std::string& s) {
+        write(s.data(), s.size());
+        return *this;
+    }
+
+    template <class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value &&
+                                                   !std::is_same<T, bool>::value,
+                                               int>::type = 0>
+    BufferedWriter& operator<<(T v) {
+        reserve(24);
+        char* p = buf.data() + pos;
+        typename std::make_unsigned<T>::type u = (typename std::make_unsigned<T>::type)v;
+        if (std::is_signed<T>::value && v < 0) {
+            *p++ = '-';
+            u = 0 - u;
+        }
+        // digits come out backwards; two at a time from the pair table
+        char tmp[24];
+        int k = 24;
+        while (u >= 100) {
+            unsigned d = (unsigned)(u % 100) * 2;
+            u /= 100;
+            tmp[--k] = digit_pairs()[d + 1];
+            tmp[--k] = digit_pairs()[d];
+        }
+        if (u >= 10) {
+            unsigned d = (unsigned)u * 2;
+            tmp[--k] = digit_pairs()[d + 1];
+            tmp[--k] = digit_pairs()[d];
+        } else {
+            tmp[--k] = (char)('0' + u);
+        }
+        std::memcpy(p, tmp + k, 24 - k);
+        pos = (std::size_t)(p - buf.data()) + (24 - k);
+        return *this;
+    }
+
+    BufferedWriter& operator<<(double x) {
+        reserve(32);
+        auto r = std::to_chars(buf.data() + pos, buf.data() + buf.size(), x, std::chars_format::general, 6);
+        pos = (std::size_t)(r.ptr - buf.data());
+        return *this;
+    }
+
+    void flush() {
+        write_fd(buf.data(), pos);
+        pos = 0;
+    }
+
+private:
+    int fd;
+    std::vector<char> buf;
+    std::size_t pos;
+
+    static const char* digit_pairs() {
+        return "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+               "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+               "8081828384858687888990919293949596979899";
+    }
+
+    void reserve(std::size_t n) {
+        if (buf.size() - pos < n) flush();
+    }
+
+    void write_fd(const char* p, std::size_t n) {
+        while (n > 0) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return;  // nowhere to report it; the caller's output is lost either way
+            }
+            p += w;
+            n -= (std::size_t)w;
+        }
+    }
+};
+
+// The MST as raw edge indices instead of text: a uint64 count followed by
+// that many int32 indices into the input edge list, native byte order.
+inline void writeEdgeIndexList(BufferedWriter& out, const std::vector<int>& edgeIds) {
+    std::uint64_t count = edgeIds.size();
+    out.write(&count, sizeof count);
+    out.write(edgeIds.data(), edgeIds.size() * sizeof(int));
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "node_pool.h"
+
+// Pairing heap with the FibHeap interface (insert / decrease_key /
+// extract_min / meld). Nodes come from a private NodePool; handles stay
+// valid until the element is extracted.
+//
+// Each node keeps its first child and its siblings; `prev` is the left
+// sibling, or the parent for a first child, which is what decrease_key
+// needs to cut a subtree in O(1).
+template <class Key, class Payload, class Compare = std::less<Key>>
+class PairingHeap {
+public:
+    struct Node {
+        Key key;
+        Payload payload;
+        Node *child, *next, *prev;
+    };
+    using handle = Node*;
+    using Pool = NodePool<Node>;
+
+    struct Entry {
+        Key key;
+        Payload payload;
+    };
+
+    explicit PairingHeap(Compare cmp = Compare()) : root(nullptr), n(0), less(cmp), pool(new Pool()) {}
+
+    bool empty() const { return root == nullptr; }
+    std::size_t size() const { return n; }
+    handle get_min() const { return root; }
+    void reserve(std::size_t count) { pool->reserve(count); }
+    const Pool* get_pool() const { return pool.get(); }
+
+    handle insert(const Key& k, Payload p) {
+        Node* x = pool->create(k, std::move(p), nullptr, nullptr, nullptr);
+        root = root == nullptr ? x : merge(root, x);
+        ++n;
+        return x;
+    }
+
+    // a k that is not smaller than the current key is ignored
+    void decrease_key(handle x, const Key& k) {
+        if (less(x->key, k)) return;
+        x->key = k;
+        if (x == root) return;
+        // cut x's subtree out of its sibling list and merge it with the root
+        if (x->prev->child == x) x->prev->child = x->next;
+        else x->prev->next = x->next;
+        if (x->next) x->next->prev = x->prev;
+        x->next = x->prev = nullptr;
+        root = merge(root, x);
+    }
+
+    // O(1): link the two roots; other is left empty. Its pool's slabs move
+    // over with the nodes, so handles into other stay valid.
+    void meld(PairingHeap& other) {
+        if (this == &other || other.root == nullptr) return;
+        pool->adopt(*other.pool);
+        root = root == nullptr ? other.root : merge(root, other.root);
+        n += other.n;
+        other.root = nullptr;
+        other.n = 0;
+    }
+
+    Entry extract_min() {
+        Node* z = root;
+        root = merge_pairs(z->child);
+        if (root) root->prev = nullptr;
+        --n;
+        Entry e{std::move(z->key), std::move(z->payload)};
+        pool->destroy(z);
+        return e;
+    }
+
+private:
+    Node* root;
+    std::size_t n;
+    Compare less;
+    std::unique_ptr<Pool> pool;
+
+    // link two roots; the loser becomes the first child of the winner
+    Node* merge(Node* a, Node* b) {
+        if (less(b->key, a->key)) std::swap(a, b);
+        b->prev = a;
+        b->next = a->child;
+        if (a->child) a->child->prev = b;
+        a->child = b;
+        a->next = nullptr;
+        return a;
+    }
+
+    // standard two-pass combine, without scratch memory: the first pass
+    // pairs siblings left to right and threads the results into a reversed
+    // list through `prev`; the second pass folds that list right to left
+    Node* merge_pairs(Node* first) {
+        if (first == nullptr) return nullptr;
+        Node* tail = nullptr;
+        while (first != nullptr) {
+            Node* a = first;
+            Node* b = a->next;
+            if (b == nullptr) {
+                a->next = nullptr;
+                a->prev = tail;
+                tail = a;
+                break;
+            }
+            first = b->next;
+            a->next = b->next = nullptr;
+            Node* m = merge(a, b);
+            m->prev = tail;
+            tail = m;
+        }
+        Node* acc = tail;
+        tail = tail->prev;
+        while (tail != nullptr) {
+            Node* up = tail->prev;
+            acc = merge(tail, acc);
+            tail = up;
+        }
+        return acc;
+    }
+};
@@ -0,0 +1,265 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "graph.h"
+#include "thread_pool.h"
+
+// Parallel Boruvka MST on a ThreadPool.
+//
+// Every phase is a handful of parallel loops over the current, contracted
+// edge list and vertex set:
+//
+//   1. scan    each thread takes a contiguous block of edges and lowers
+//              best[u] and best[v] with a compare-and-swap loop; edges are
+//              ordered by (weight, input index), a strict total order, so
+//              the chosen edges form a forest plus 2-cycles
+//   2. hook    every vertex points at the other end of its best edge; of a
+//              mutual pair the smaller id becomes the root
+//   3. jump    pointer jumping until every vertex points at its root
+//   4. relabel roots get dense ids through per-thread counts and a prefix
+//              sum; vertices without any edge left are finished and dropped
+//   5. filter  edges are relabelled, self-loops dropped, and the survivors
+//              compacted (again counts + prefix sum) into the next edge list
+//
+//   6. merge   once the vertex count is well below the edge count, parallel
+//              edges are merged too (mergeParallelEdges below)
+//
+// No step takes a lock or calls find(). Works on any EdgeT with members
+// u, v, w (0-indexed); the result refers to edges by input index.
+
+struct BoruvkaPhase {
+    int n;              // vertices at the start of the phase
+    std::size_t m;      // edges at the start of the phase
+    std::size_t added;  // MST edges found in the phase
+    double ms;
+};
+
+template <class W>
+struct BoruvkaResult {
+    W totalWeight = W();
+    std::vector<int> edges;  // input edge indices of the minimum spanning forest
+    std::vector<BoruvkaPhase> phases;
+};
+
+// Edge of the contracted graph; id is the input edge it stands for.
+template <class W>
+struct BoruvkaEdge {
+    int u, v;
+    W w;
+    int id;
+};
+
+// out = map(i) for every i in [0, n) with keep(i), in index order
+template <class T, class Keep, class Map>
+void parallelFilter(ThreadPool& pool, std::size_t n, std::vector<T>& out, Keep keep, Map map) {
+    std::vector<std::size_t> at(pool.size() + 1, 0);
+    pool.for_chunks(n, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        std::size_t c = 0;
+        for (std::size_t i = lo; i < hi; i++) c += keep(i);
+        at[t + 1] = c;
+    });
+    for (unsigned t = 0; t < pool.size(); t++) at[t + 1] += at[t];
+    out.resize(at[pool.size()]);
+    pool.for_chunks(n, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        std::size_t o = at[t];
+        for (std::size_t i = lo; i < hi; i++)
+            if (keep(i)) out[o++] = map(i);
+    });
+}
+
+// Keeps only the lightest of every bundle of parallel edges, in the scan's
+// (w, id) order. A counting sort by smaller endpoint with per-thread
+// histograms groups the bundles; then each thread deduplicates the buckets
+// of its own vertex range in place through a private slot[] array, and the
+// survivors are compacted back into `edges`. Needs T * n counters, so it
+// only pays once n has dropped well below m. tmp is scratch space.
+template <class W>
+void mergeParallelEdges(ThreadPool& pool, int n, std::vector<BoruvkaEdge<W>>& edges,
+                        std::vector<BoruvkaEdge<W>>& tmp) {
+    unsigned T = pool.size();
+    std::size_t m = edges.size(), N = (std::size_t)n;
+    std::vector<std::size_t> pos(T * N, 0);  // pos[t * n + c]
+    pool.for_chunks(m, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        std::size_t* h = &pos[t * N];
+        for (std::size_t i = lo; i < hi; i++) {
+            BoruvkaEdge<W>& e = edges[i];
+            if (e.u > e.v) std::swap(e.u, e.v);
+            h[e.u]++;
+        }
+    });
+    // exclusive prefix sum in (vertex, thread) order
+    std::vector<std::size_t> at(T + 1, 0);
+    pool.for_chunks(N, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        std::size_t sum = 0;
+        for (std::size_t c = lo; c < hi; c++) {
+            for (unsigned k = 0; k < T; k++) {
+                std::size_t x = pos[k * N + c];
+                pos[k * N + c] = sum;
+                sum += x;
+            }
+        }
+        at[t + 1] = sum;
+    });
+    for (unsigned t = 0; t < T; t++) at[t + 1] += at[t];
+    pool.for_chunks(N, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        for (std::size_t c = lo; c < hi; c++)
+            for (unsigned k = 0; k < T; k++) pos[k * N + c] += at[t];
+    });
+    tmp.resize(m);
+    pool.for_chunks(m, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        std::size_t* p = &pos[t * N];
+        for (std::size_t i = lo; i < hi; i++) tmp[p[edges[i].u]++] = edges[i];
+    });
+    // the last thread's cursors now sit at the end of every bucket
+    const std::size_t* bucketEnd = &pos[(T - 1) * N];
+
+    std::vector<std::size_t> kept(T + 1, 0);
+    pool.for_chunks(N, [&](unsigned t, std::size_t lo, std::size_t hi) {
+        std::vector<int> slot(N, -1);  // position of the kept edge c -- v, per v
+        std::size_t w = lo == 0 ? 0 : bucketEnd[lo - 1], first = w;
+        for (std::size_t c = lo; c < hi; c++) {
+            std::size_t begin = w, i = c == 0 ? 0 : bucketEnd[c - 1];
+            for (; i < bucketEnd[c]; i++) {
+                const BoruvkaEdge<W> e = tmp[i];
+                int& s = slot[e.v];
+                if (s == -1) {
+                    s = (int)(w - begin);
+                    tmp[w++] = e;
+                } else {
+                    BoruvkaEdge<W>& k = tmp[begin + s];
+                    if (e.w < k.w || (e.w == k.w && e.id < k.id)) k = e;
+                }
+            }
+            for (std::size_t j = begin; j < w; j++) slot[tmp[j].v] = -1;
+        }
+        kept[t + 1] = w - first;
+    });
+    for (unsigned t = 0; t < T; t++) kept[t + 1] += kept[t];
+    edges.resize(kept[T]);
+    pool.for_chunks(N, [&](unsigned t, std::size_t lo, std::size_t) {
+        std::size_t from = lo == 0 ? 0 : bucketEnd[lo - 1];
+        std::copy(tmp.begin() + from, tmp.begin() + from + (kept[t + 1] - kept[t]), edges.begin() + kept[t]);
+    });
+}
+
+template <class EdgeT, class W = decltype(EdgeT::w)>
+BoruvkaResult<W> parallelBoruvkaMST(int n, ArrayView<EdgeT> input, ThreadPool& pool) {
+    BoruvkaResult<W> r;
+    unsigned T = pool.size();
+    std::vector<BoruvkaEdge<W>> cur, next;
+    parallelFilter(
+        pool, input.size(), cur, [&](std::size_t i) { return input[i].u != input[i].v; },
+        [&](std::size_t i) { return BoruvkaEdge<W>{input[i].u, input[i].v, input[i].w, (int)i}; });
+
+    std::vector<std::atomic<int>> best(n);
+    std::vector<int> parent(n), jumped(n), label(n);
+    std::vector<std::vector<int>> added(T);
+    std::vector<std::size_t> at(T + 1);
+    std::vector<char> changed(T);
+    int nc = n;
+
+    auto lighter = [&](int a, int b) {
+        return cur[a].w < cur[b].w || (cur[a].w == cur[b].w && cur[a].id < cur[b].id);
+    };
+    auto lower = [&](std::atomic<int>& slot, int e) {
+        int old = slot.load(std::memory_order_relaxed);
+        while ((old == -1 || lighter(e, old)) &&
+               !slot.compare_exchange_weak(old, e, std::memory_order_relaxed)) {
+        }
+    };
+
+    while (!cur.empty()) {
+        auto t0 = std::chrono::steady_clock::now();
+        std::size_t m = cur.size();
+
+        // 1. cheapest edge per vertex
+        pool.for_chunks(nc, [&](unsigned, std::size_t lo, std::size_t hi) {
+            for (std::size_t c = lo; c < hi; c++) best[c].store(-1, std::memory_order_relaxed);
+        });
+        pool.for_chunks(m, [&](unsigned, std::size_t lo, std::size_t hi) {
+            for (std::size_t i = lo; i < hi; i++) {
+                lower(best[cur[i].u], (int)i);
+                lower(best[cur[i].v], (int)i);
+            }
+        });
+
+        // 2. hook; each chosen edge is recorded by exactly one endpoint
+        pool.for_chunks(nc, [&](unsigned t, std::size_t lo, std::size_t hi) {
+            added[t].clear();
+            for (std::size_t c = lo; c < hi; c++) {
+                int b = best[c].load(std::memory_order_relaxed);
+                if (b == -1) {
+                    parent[c] = (int)c;
+                    continue;
+                }
+                int other = cur[b].u ^ cur[b].v ^ (int)c;
+                if (best[other].load(std::memory_order_relaxed) == b && (int)c < other) {
+                    parent[c] = (int)c;
+                } else {
+                    parent[c] = other;
+                    added[t].push_back(cur[b].id);
+                }
+            }
+        });
+
+        // 3. pointer jumping, double-buffered so every round reads a stable array
+        while (true) {
+            pool.for_chunks(nc, [&](unsigned t, std::size_t lo, std::size_t hi) {
+                char any = 0;
+                for (std::size_t c = lo; c < hi; c++) {
+                    jumped[c] = parent[parent[c]];
+                    any |= jumped[c] != parent[c];
+                }
+                changed[t] = any;
+            });
+            parent.swap(jumped);
+            bool any = false;
+            for (char c : changed) any |= c != 0;
+            if (!any) break;
+        }
+
+        // 4. dense ids for the roots that still have edges
+        pool.for_chunks(nc, [&](unsigned t, std::size_t lo, std::size_t hi) {
+            std::size_t k = 0;
+            for (std::size_t c = lo; c < hi; c++)
+                k += parent[c] == (int)c && best[c].load(std::memory_order_relaxed) != -1;
+            at[t + 1] = k;
+        });
+        at[0] = 0;
+        for (unsigned t = 0; t < T; t++) at[t + 1] += at[t];
+        pool.for_chunks(nc, [&](unsigned t, std::size_t lo, std::size_t hi) {
+            int id = (int)at[t];
+            for (std::size_t c = lo; c < hi; c++)
+                jumped[c] = parent[c] == (int)c && best[c].load(std::memory_order_relaxed) != -1 ? id++ : -1;
+        });
+        pool.for_chunks(nc, [&](unsigned, std::size_t lo, std::size_t hi) {
+            for (std::size_t c = lo; c < hi; c++) label[c] = jumped[parent[c]];
+        });
+
+        // 5. contract
+        parallelFilter(
+            pool, m, next, [&](std::size_t i) { return label[cur[i].u] != label[cur[i].v]; },
+            [&](std::size_t i) {
+                const BoruvkaEdge<W>& e = cur[i];
+                return BoruvkaEdge<W>{label[e.u], label[e.v], e.w, e.id};
+            });
+        cur.swap(next);
+        // 6. the counters cost T per vertex; worth it once they are few
+        if ((std::size_t)at[T] * T * 4 <= cur.size()) mergeParallelEdges(pool, (int)at[T], cur, next);
+
+        std::size_t count = 0;
+        for (const std::vector<int>& a : added) {
+            r.edges.insert(r.edges.end(), a.begin(), a.end());
+            count += a.size();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        r.phases.push_back(BoruvkaPhase{nc, m, count, ms});
+        nc = (int)at[T];
+    }
+    for (int id : r.edges) r.totalWeight += input[id].w;
+    return r;
+}
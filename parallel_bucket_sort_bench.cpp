@@ -0,0 +1,55 @@
+// Strong scaling of the parallel bucket sort (bucket_sort.h): one fixed
+// array of random integers, sorted with 1, 2, 4, ... threads.
+//
+//   g++ -O2 -std=c++17 -pthread parallel_bucket_sort_bench.cpp -o parallel_bucket_sort_bench
+//   ./parallel_bucket_sort_bench [n] [max_threads] [rounds] [dist]
+//
+// Defaults: n = 10^8, max_threads = hardware threads, 3 rounds, uniform.
+// dist is uniform (full 64-bit range) or skewed (exponential: most values
+// in a few buckets, which the work stealing has to even out). The input and
+// two working copies are 24 bytes per value, so n = 10^9 needs about 24 GB.
+// For each thread count prints the best wall time, the speedup and parallel
+// efficiency against one thread, and checks the result against std::sort.
+#include <bits/stdc++.h>
+#include "bucket_sort.h"
+#include "thread_pool.h"
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? atoll(argv[1]) : 100000000;
+    unsigned maxThreads = argc > 2 ? (unsigned)atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+    int rounds = argc > 3 ? atoi(argv[3]) : 3;
+    string dist = argc > 4 ? argv[4] : "uniform";
+
+    mt19937_64 rng(5);
+    exponential_distribution<double> expo(1.0);
+    vector<long long> input(n);
+    for (auto& x : input) x = dist == "skewed" ? (long long)(expo(rng) * 1e9) : (long long)rng();
+    vector<long long> expect = input;
+    sort(expect.begin(), expect.end());
+    printf("n=%zu dist=%s, hardware threads %u\n", n, dist.c_str(), thread::hardware_concurrency());
+    printf("%8s %10s %8s %10s\n", "threads", "time_ms", "speedup", "efficiency");
+
+    double base = 0;
+    vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+    vector<long long> a;
+    for (unsigned t : counts) {
+        ThreadPool pool(t);
+        double best = 1e18;
+        for (int r = 0; r < rounds; r++) {
+            a = input;
+            auto t0 = chrono::steady_clock::now();
+            bucketSort(a, 0, &pool);
+            best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+            if (a != expect) {
+                fprintf(stderr, "wrong order with %u threads\n", t);
+                return 1;
+            }
+        }
+        if (t == 1) base = best;
+        printf("%8u %10.1f %8.2f %9.0f%%\n", t, best, base / best, 100 * base / best / t);
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <climits>
+#include <vector>
+#include "graph.h"
+#include "heap_batch.h"
+
+// Prim's MST, templated on the priority queue. Any heap works that offers
+//
+//   handle insert(long long key, int vertex);
+//   void   decrease_key(handle, long long key);
+//   Entry  extract_min();   // .key, .payload
+//   bool   empty();
+//   void   reserve(size_t);
+//
+// i.e. FibHeap, CompactFibHeap, DaryHeap and PairingHeap. The updates go
+// through a HeapBatch (heap_batch.h), so a heap with bulk operations gets
+// each vertex's relaxations, and the eager start's n inserts, in one call.
+
+using PrimGraph = CsrGraph<long long>;
+
+struct PrimResult {
+    long long totalWeight = 0;
+    std::vector<int> parent;      // -1 for the root of each tree
+    std::vector<long long> dist;  // weight of the tree edge into each vertex, 0 for roots
+    std::vector<int> parentEdge;  // input edge index of that tree edge, if g has edge ids
+    int trees = 0;                // > 1 when the graph is disconnected
+};
+
+// Computes a minimum spanning forest, starting from vertex 0.
+//
+// eager (lazy = false): every vertex is inserted up front with key
+// LLONG_MAX, so the first extract_min consolidates an n-long root list;
+// once the component of 0 is done, the next LLONG_MAX vertex the queue
+// yields roots the next tree.
+// lazy: a vertex is inserted when first reached and decreased afterwards,
+// so the queue only ever holds the current frontier; when it runs dry the
+// lowest numbered vertex not yet in the forest roots the next tree.
+//
+// H must be empty; it is passed in so callers can inspect it afterwards.
+template <class Heap>
+PrimResult primMST(const PrimGraph& g, Heap& H, bool lazy = false) {
+    int n = g.n;
+    PrimResult r;
+    r.dist.assign(n, LLONG_MAX);
+    r.parent.assign(n, -1);
+    if (g.edgeId != nullptr) r.parentEdge.assign(n, -1);
+    if (n == 0) return r;
+
+    enum : char { UNSEEN, QUEUED, DONE };
+    std::vector<typename Heap::handle> nodes(n);
+    std::vector<char> state(n, UNSEEN);
+
+    HeapBatch<Heap> batch;
+    if (!lazy) {
+        H.reserve(n);
+        batch.begin(n);
+        for (int i = 0; i < n; i++) {
+            batch.insert(H, r.dist[i], i, nodes[i]);
+            state[i] = QUEUED;
+        }
+        batch.flush(H);
+        // start at 0
+        H.decrease_key(nodes[0], 0);
+    }
+
+    int next = 0;  // lowest vertex that might still start a tree
+    for (;;) {
+        if (lazy) {
+            while (next < n && state[next] != UNSEEN) next++;
+            if (next == n) break;
+            nodes[next] = H.insert(0, next);
+            state[next] = QUEUED;
+        } else if (H.empty()) {
+            break;
+        }
+        while (!H.empty()) {
+            auto uNode = H.extract_min();
+            int u = uNode.payload;
+            state[u] = DONE;
+            if (r.parent[u] == -1) {
+                // nothing reached u: it roots a new tree
+                r.dist[u] = 0;
+                r.trees++;
+            }
+            r.totalWeight += r.dist[u];
+
+            batch.begin(g.end(u) - g.begin(u));
+            for (std::size_t a = g.begin(u); a < g.end(u); a++) {
+                int v = g.target[a];
+                long long w = g.weight[a];
+                if (state[v] == DONE || w >= r.dist[v]) continue;
+                r.dist[v] = w;
+                r.parent[v] = u;
+                if (g.edgeId != nullptr) r.parentEdge[v] = g.edgeId[a];
+                if (state[v] == UNSEEN) {
+                    batch.insert(H, w, v, nodes[v]);
+                    state[v] = QUEUED;
+                } else {
+                    batch.decrease_key(H, nodes[v], w);
+                }
+            }
+            batch.flush(H);
+        }
+    }
+    return r;
+}
@@ -0,0 +1,86 @@
+// Head-to-head of Prim's priority-queue backends.
+//
+//   g++ -O2 -std=c++17 prim_bench.cpp -o prim_bench
+//   ./prim_bench [sparse_n] [dense_n] [rounds]
+//
+// Sparse graphs have m = 8n random edges, dense ones m = n^2/4. For each
+// backend, in eager and lazy seeding mode, prints the best wall time over
+// `rounds` and the peak number of bytes the run had live on the heap beyond
+// the graph itself (tracked by the operator new / delete replacements below).
+#include <bits/stdc++.h>
+#include <malloc.h>
+#include "bench_graphs.h"
+#include "bucket_queue.h"
+#include "compact_fib_heap.h"
+#include "dary_heap.h"
+#include "fib_heap.h"
+#include "pairing_heap.h"
+#include "prim.h"
+using namespace std;
+
+static size_t g_live = 0, g_peak = 0;
+void* operator new(size_t sz) {
+    void* p = malloc(sz ? sz : 1);
+    if (!p) throw bad_alloc();
+    g_live += malloc_usable_size(p);
+    g_peak = max(g_peak, g_live);
+    return p;
+}
+// kept out of line so GCC does not flag the inlined free() as mismatched
+__attribute__((noinline)) static void release(void* p) {
+    if (p) g_live -= malloc_usable_size(p);
+    free(p);
+}
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+
+template <class Heap, class... HeapArgs>
+void benchMode(const PrimGraph& g, int rounds, bool lazy, double& best, size_t& peak, long long& weight,
+               HeapArgs... heapArgs) {
+    best = 1e18;
+    for (int r = 0; r < rounds; r++) {
+        size_t base = g_live;
+        g_peak = g_live;
+        auto t0 = chrono::steady_clock::now();
+        {
+            Heap H(heapArgs...);
+            weight = primMST(g, H, lazy).totalWeight;
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        best = min(best, ms);
+        peak = g_peak - base;
+    }
+}
+
+template <class Heap, class... HeapArgs>
+void bench(const char* name, const PrimGraph& g, int rounds, HeapArgs... heapArgs) {
+    double eagerMs, lazyMs;
+    size_t eagerPeak, lazyPeak;
+    long long eagerWeight, lazyWeight;
+    benchMode<Heap>(g, rounds, false, eagerMs, eagerPeak, eagerWeight, heapArgs...);
+    benchMode<Heap>(g, rounds, true, lazyMs, lazyPeak, lazyWeight, heapArgs...);
+    printf("  %-10s eager %9.2f ms %8.1f MiB   lazy %9.2f ms %8.1f MiB   weight %lld%s\n", name, eagerMs,
+           eagerPeak / 1048576.0, lazyMs, lazyPeak / 1048576.0, eagerWeight,
+           eagerWeight == lazyWeight ? "" : "  MISMATCH");
+}
+
+static void benchAll(const char* label, const PrimGraph& g, int rounds) {
+    printf("%s: n=%d m=%zu\n", label, g.n, g.arcs() / 2);
+    bench<FibHeap<long long, int>>("fib", g, rounds);
+    bench<CompactFibHeap<long long, int>>("compact", g, rounds);
+    bench<DaryHeap<long long, int, 2>>("binary", g, rounds);
+    bench<DaryHeap<long long, int, 4>>("dary4", g, rounds);
+    bench<PairingHeap<long long, int>>("pairing", g, rounds);
+    // the weights are 1 .. 10^6
+    bench<DialQueue<long long, int>>("dial", g, rounds, (uint64_t)1000000);
+}
+
+int main(int argc, char** argv) {
+    int sparseN = argc > 1 ? atoi(argv[1]) : 1000000;
+    int denseN = argc > 2 ? atoi(argv[2]) : 4000;
+    int rounds = argc > 3 ? atoi(argv[3]) : 3;
+
+    benchAll("sparse", randomGraph<PrimGraph>(sparseN, 8LL * sparseN, 1), rounds);
+    benchAll("dense", randomGraph<PrimGraph>(denseN, (long long)denseN * denseN / 4, 2), rounds);
+    return 0;
+}
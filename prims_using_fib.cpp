@@ -1,231 +1,105 @@
 #include <bits/stdc++.h>
+#include "bucket_queue.h"
+#include "compact_fib_heap.h"
+#include "dary_heap.h"
+#include "fib_heap.h"
+#include "graph_binary.h"
+#include "output_writer.h"
+#include "pairing_heap.h"
+#include "prim.h"
 using namespace std;
 
-struct FibNode {
-    int vertex;
-    long long key;
-    FibNode *parent, *child, *left, *right;
-    int degree;
-    bool mark;
-    FibNode(int v, long long k) : vertex(v), key(k), parent(nullptr), child(nullptr),
-        left(this), right(this), degree(0), mark(false) {}
-};
+// key = cheapest known edge into the vertex, payload = the vertex
+using PrimHeap = FibHeap<long long, int>;
 
-struct FibHeap {
-    FibNode* minNode;
-    int nNodes;
-
-    FibHeap() : minNode(nullptr), nNodes(0) {}
-
-    void insert(FibNode* x) {
-        if (!minNode) {
-            minNode = x;
-        } else {
-            // insert into root list
-            x->left = minNode;
-            x->right = minNode->right;
-            minNode->right->left = x;
-            minNode->right = x;
-            if (x->key < minNode->key) minNode = x;
-        }
-        nNodes++;
-    }
-
-    void link(FibNode* y, FibNode* x) {
-        // remove y from root list
-        y->left->right = y->right;
-        y->right->left = y->left;
-        // make y child of x
-        y->parent = x;
-        if (!x->child) {
-            x->child = y;
-            y->left = y->right = y;
-        } else {
-            y->left = x->child;
-            y->right = x->child->right;
-            x->child->right->left = y;
-            x->child->right = y;
-        }
-        x->degree++;
-        y->mark = false;
-    }
-
-    void consolidate() {
-        int D = 50; // log2(n) upper bound
-        vector<FibNode*> A(D, nullptr);
-
-        vector<FibNode*> roots;
-        if (minNode) {
-            FibNode* x = minNode;
-            do {
-                roots.push_back(x);
-                x = x->right;
-            } while (x != minNode);
-        }
-
-        for (FibNode* w : roots) {
-            FibNode* x = w;
-            int d = x->degree;
-            while (A[d]) {
-                FibNode* y = A[d];
-                if (x->key > y->key) swap(x, y);
-                link(y, x);
-                A[d] = nullptr;
-                d++;
-            }
-            A[d] = x;
-        }
-
-        minNode = nullptr;
-        for (FibNode* a : A) {
-            if (a) {
-                if (!minNode) {
-                    a->left = a->right = a;
-                    minNode = a;
-                } else {
-                    a->left = minNode;
-                    a->right = minNode->right;
-                    minNode->right->left = a;
-                    minNode->right = a;
-                    if (a->key < minNode->key) minNode = a;
-                }
-            }
-        }
-    }
+// node allocator counters, for the heaps that have a pool
+template <class Heap>
+auto reportPool(const Heap& H, int) -> decltype(H.get_pool()->stats(), void()) {
+    cerr << "pool: " << H.get_pool()->stats() << "\n";
+}
+template <class Heap>
+void reportPool(const Heap&, long) {}
+
+template <class Heap, class... HeapArgs>
+PrimResult runPrim(const PrimGraph& g, bool lazy, bool poolStats, HeapArgs... heapArgs) {
+    Heap H(heapArgs...);
+    PrimResult r = primMST(g, H, lazy);
+    if (poolStats) reportPool(H, 0);
+    return r;
+}
 
-    FibNode* extractMin() {
-        FibNode* z = minNode;
-        if (z) {
-            // add children to root list
-            if (z->child) {
-                vector<FibNode*> children;
-                FibNode* c = z->child;
-                do {
-                    children.push_back(c);
-                    c = c->right;
-                } while (c != z->child);
-                for (FibNode* x : children) {
-                    x->parent = nullptr;
-                    x->left = minNode;
-                    x->right = minNode->right;
-                    minNode->right->left = x;
-                    minNode->right = x;
-                }
-            }
-            // remove z
-            z->left->right = z->right;
-            z->right->left = z->left;
-            if (z == z->right) {
-                minNode = nullptr;
-            } else {
-                minNode = z->right;
-                consolidate();
-            }
-            nNodes--;
-        }
-        return z;
+// ---- Prim's MST engine (prim.h) on a selectable queue ----
+// --heap=auto|fib|compact|binary|dary4|pairing|dial
+//                                          priority queue; auto (the default)
+//                                          takes Dial's bucket queue when the
+//                                          weights span at most 2^20 values,
+//                                          fib otherwise
+// --lazy                                   insert vertices on first discovery
+// --pool-stats                             node allocator counters on stderr
+// --binary-out                             write the tree as an edge index list
+// [input]                                  text edge list or binary graph file
+//                                          (default: text on stdin)
+// Disconnected input yields a minimum spanning forest.
+int main(int argc, char** argv) {
+    bool lazy = false, poolStats = false, binaryOut = false;
+    string heap = "auto";
+    const char* input = nullptr;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--pool-stats") poolStats = true;
+        else if (arg == "--lazy") lazy = true;
+        else if (arg == "--binary-out") binaryOut = true;
+        else if (arg.rfind("--heap=", 0) == 0) heap = arg.substr(7);
+        else input = argv[i];
     }
-
-    void cut(FibNode* x, FibNode* y) {
-        // remove x from child list of y
-        if (x->right == x) {
-            y->child = nullptr;
-        } else {
-            x->left->right = x->right;
-            x->right->left = x->left;
-            if (y->child == x) y->child = x->right;
-        }
-        y->degree--;
-        // add x to root list
-        x->parent = nullptr;
-        x->left = minNode;
-        x->right = minNode->right;
-        minNode->right->left = x;
-        minNode->right = x;
-        x->mark = false;
+    LoadedGraph<WeightedEdge<long long>> in;
+    if (!in.load(input, 1, binaryOut)) {
+        cerr << (input ? input : "stdin") << ": " << in.error << "\n";
+        return 1;
     }
-
-    void cascadingCut(FibNode* y) {
-        FibNode* z = y->parent;
-        if (z) {
-            if (!y->mark) {
-                y->mark = true;
-            } else {
-                cut(y, z);
-                cascadingCut(z);
-            }
-        }
+    in.dropEdges();
+    int n = in.n;
+    const PrimGraph& g = in.g;
+
+    // one Dial bucket per distinct weight value in [min, max]
+    uint64_t width = 1;
+    if (g.arcs() > 0) {
+        auto range = minmax_element(g.weight, g.weight + g.arcs());
+        width = (uint64_t)*range.second - (uint64_t)*range.first + 1;
     }
+    if (heap == "auto") heap = width <= DIAL_MAX_WIDTH ? "dial" : "fib";
 
-    void decreaseKey(FibNode* x, long long k) {
-        if (k > x->key) return; // invalid
-        x->key = k;
-        FibNode* y = x->parent;
-        if (y && x->key < y->key) {
-            cut(x, y);
-            cascadingCut(y);
+    PrimResult r;
+    if (heap == "dial") {
+        if (width > DIAL_MAX_WIDTH) {
+            cerr << "dial: weights span " << width << " values, more than " << DIAL_MAX_WIDTH << "\n";
+            return 1;
         }
-        if (x->key < minNode->key) minNode = x;
+        r = runPrim<DialQueue<long long, int>>(g, lazy, poolStats, width);
+    } else if (heap == "fib") r = runPrim<PrimHeap>(g, lazy, poolStats);
+    else if (heap == "compact") r = runPrim<CompactFibHeap<long long, int>>(g, lazy, poolStats);
+    else if (heap == "binary") r = runPrim<DaryHeap<long long, int, 2>>(g, lazy, poolStats);
+    else if (heap == "dary4") r = runPrim<DaryHeap<long long, int, 4>>(g, lazy, poolStats);
+    else if (heap == "pairing") r = runPrim<PairingHeap<long long, int>>(g, lazy, poolStats);
+    else {
+        cerr << "unknown heap '" << heap << "'\n";
+        return 1;
     }
 
-    bool empty() { return minNode == nullptr; }
-};
-
-// ---- Prim’s using FibHeap ----
-int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    int n, m;
-    cin >> n >> m;
-    vector<vector<pair<int,long long>>> adj(n);
-    for (int i=0;i<m;i++){
-        int u,v; long long w;
-        cin >> u >> v >> w;
-        --u; --v;
-        adj[u].push_back({v,w});
-        adj[v].push_back({u,w});
+    BufferedWriter out;
+    if (binaryOut) {
+        vector<int> ids;
+        for (int i = 0; i < n; i++)
+            if (r.parent[i] != -1) ids.push_back(r.parentEdge[i]);
+        writeEdgeIndexList(out, ids);
+        return 0;
     }
-
-    vector<long long> dist(n, LLONG_MAX);
-    vector<int> parent(n,-1);
-    vector<FibNode*> nodes(n);
-
-    FibHeap H;
-
-    for (int i=0;i<n;i++){
-        nodes[i] = new FibNode(i, dist[i]);
-        H.insert(nodes[i]);
-    }
-    // start at 0
-    H.decreaseKey(nodes[0],0);
-    dist[0]=0;
-
-    long long totalWeight=0;
-
-    while(!H.empty()){
-        FibNode* uNode=H.extractMin();
-        int u=uNode->vertex;
-        long long d=uNode->key;
-        totalWeight+= (d==LLONG_MAX?0:d);
-
-        for(auto &edge: adj[u]){
-            int v=edge.first;
-            long long w=edge.second;
-            if(nodes[v] && w<dist[v]){
-                dist[v]=w;
-                parent[v]=u;
-                H.decreaseKey(nodes[v],w);
-            }
-        }
-        // mark removed
-        nodes[u]=nullptr;
-    }
-
-    cout<<"Total MST weight: "<<totalWeight<<"\n";
-    cout<<"Edges in MST:\n";
-    for(int i=1;i<n;i++){
-        cout<<parent[i]+1<<" "<<i+1<<" "<<dist[i]<<"\n";
+    out<<"Total MST weight: "<<r.totalWeight<<"\n";
+    if(r.trees>1) out<<"Graph is disconnected: spanning forest of "<<r.trees<<" trees\n";
+    out<<"Edges in MST:\n";
+    for(int i=0;i<n;i++){
+        if(r.parent[i]==-1) continue; // tree root
+        out<<r.parent[i]+1<<' '<<i+1<<' '<<r.dist[i]<<'\n';
     }
     return 0;
 }
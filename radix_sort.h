@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+// LSD radix sort for records keyed by a 64-bit integer, in 8-bit digits:
+// per digit one histogram and one stable scatter into a second buffer.
+// Digits on which every key agrees are skipped, so edge weights below 2^32
+// cost four passes, not eight.
+//
+// radixKey() maps the weight types to unsigned keys with the same order:
+// signed integers get their sign bit flipped; doubles get the sign bit
+// flipped when positive and all bits flipped when negative, so the bit
+// patterns compare like the values (with -0.0 just below +0.0).
+//
+// With a ThreadPool every pass runs as per-thread histograms of one chunk
+// each, a prefix sum in (digit, thread) order, and a per-thread scatter; the
+// result is identical to the serial one.
+
+inline std::uint64_t radixKey(long long x) { return (std::uint64_t)x ^ 0x8000000000000000ull; }
+inline std::uint64_t radixKey(int x) { return (std::uint64_t)(std::uint32_t)x ^ 0x80000000ull; }
+inline std::uint64_t radixKey(double x) {
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof b);
+    return (b & 0x8000000000000000ull) ? ~b : b | 0x8000000000000000ull;
+}
+
+// Stable sort of a[0, n) by key(a[i]) (a radixKey()); tmp must hold n
+// elements. The result ends up in a.
+template <class T, class Key>
+void radixSort(T* a, T* tmp, std::size_t n, Key key, ThreadPool* pool = nullptr) {
+    const int DIGITS = 8, RADIX = 256;
+    if (n < 2) return;
+    T* src = a;
+    T* dst = tmp;
+
+    if (pool == nullptr || pool->size() == 1) {
+        // all eight histograms in one read
+        std::vector<std::size_t> count(DIGITS * RADIX, 0);
+        for (std::size_t i = 0; i < n; i++) {
+            std::uint64_t k = key(a[i]);
+            for (int d = 0; d < DIGITS; d++) count[d * RADIX + ((k >> (8 * d)) & 0xff)]++;
+        }
+        for (int d = 0; d < DIGITS; d++) {
+            std::size_t* c = &count[d * RADIX];
+            if (*std::max_element(c, c + RADIX) == n) continue;
+            std::size_t sum = 0;
+            for (int b = 0; b < RADIX; b++) {
+                std::size_t x = c[b];
+                c[b] = sum;
+                sum += x;
+            }
+            for (std::size_t i = 0; i < n; i++) dst[c[(key(src[i]) >> (8 * d)) & 0xff]++] = src[i];
+            std::swap(src, dst);
+        }
+        if (src != a) std::copy(src, src + n, a);
+        return;
+    }
+
+    unsigned threads = pool->size();
+    std::vector<std::size_t> count((std::size_t)threads * RADIX);  // count[t * RADIX + b]
+    for (int d = 0; d < DIGITS; d++) {
+        int shift = 8 * d;
+        pool->for_chunks(n, [&](unsigned t, std::size_t lo, std::size_t hi) {
+            std::size_t* c = &count[(std::size_t)t * RADIX];
+            std::fill(c, c + RADIX, 0);
+            for (std::size_t i = lo; i < hi; i++) c[(key(src[i]) >> shift) & 0xff]++;
+        });
+        std::size_t sum = 0;
+        bool trivial = false;
+        for (int b = 0; b < RADIX; b++) {
+            std::size_t before = sum;
+            for (unsigned t = 0; t < threads; t++) {
+                std::size_t x = count[(std::size_t)t * RADIX + b];
+                count[(std::size_t)t * RADIX + b] = sum;
+                sum += x;
+            }
+            if (sum - before == n) trivial = true;
+        }
+        if (trivial) continue;
+        pool->for_chunks(n, [&](unsigned t, std::size_t lo, std::size_t hi) {
+            std::size_t* c = &count[(std::size_t)t * RADIX];
+            for (std::size_t i = lo; i < hi; i++) dst[c[(key(src[i]) >> shift) & 0xff]++] = src[i];
+        });
+        std::swap(src, dst);
+    }
+    if (src != a) {
+        pool->for_chunks(n, [&](unsigned, std::size_t lo, std::size_t hi) { std::copy(src + lo, src + hi, a + lo); });
+    }
+}
+
+template <class T, class Key>
+void radixSort(std::vector<T>& a, Key key, ThreadPool* pool = nullptr) {
+    std::vector<T> tmp(a.size());
+    radixSort(a.data(), tmp.data(), a.size(), key, pool);
+}
+
+// The permutation that sorts [0, n) stably by key(i), for callers that want
+// to leave their records where they are. Sorts (key, index) pairs, so the
+// passes never chase indices into the records.
+template <class Key>
+std::vector<int> radixSortedOrder(std::size_t n, Key key, ThreadPool* pool = nullptr) {
+    std::vector<std::pair<std::uint64_t, int>> p(n);
+    for (std::size_t i = 0; i < n; i++) p[i] = {key(i), (int)i};
+    radixSort(p, [](const std::pair<std::uint64_t, int>& x) { return x.first; }, pool);
+    std::vector<int> order(n);
+    for (std::size_t i = 0; i < n; i++) order[i] = p[i].second;
+    return order;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed set of worker threads for the parallel MST / sorting code.
+//
+//   ThreadPool pool(threads);
+//   pool.run([&](unsigned t) { ... });                 // once per thread
+//   pool.for_chunks(n, [&](unsigned t, size_t lo, size_t hi) { ... });
+//
+// Every call is a fork-join: it returns once all threads are done, so the
+// steps of an algorithm can be written as a sequence of parallel loops with
+// an implicit barrier between them. The calling thread works as thread 0,
+// so a pool of size 1 runs everything inline with no synchronisation.
+// for_chunks hands thread t the t-th of size() contiguous, equally sized
+// ranges; algorithms rely on that fixed mapping for per-thread counts and
+// prefix sums.
+class ThreadPool {
+public:
+    // threads = 0 means one per hardware thread
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        workers.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; t++) workers.emplace_back([this, t] { worker(t); });
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& w : workers) w.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size() + 1; }
+
+    // fn(t) on every thread t in [0, size()); returns when all have finished
+    void run(const std::function<void(unsigned)>& fn) {
+        if (workers.empty()) {
+            fn(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            job = &fn;
+            pending = (unsigned)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        fn(0);
+        std::unique_lock<std::mutex> lock(mu);
+        done.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+    // [lo, hi) of chunk t when [0, n) is split into size() near-equal parts
+    std::pair<std::size_t, std::size_t> chunk(std::size_t n, unsigned t) const {
+        std::size_t parts = size();
+        return {n * t / parts, n * (t + 1) / parts};
+    }
+
+    template <class F>
+    void for_chunks(std::size_t n, F&& fn) {
+        run([&](unsigned t) {
+            std::pair<std::size_t, std::size_t> r = chunk(n, t);
+            fn(t, r.first, r.second);
+        });
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mu;
+    std::condition_variable wake, done;
+    const std::function<void(unsigned)>* job = nullptr;
+    unsigned long long generation = 0;
+    unsigned pending = 0;
+    bool stopping = false;
+
+    void worker(unsigned t) {
+        unsigned long long seen = 0;
+        while (true) {
+            const std::function<void(unsigned)>* fn;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+            }
+            (*fn)(t);
+            std::lock_guard<std::mutex> lock(mu);
+            if (--pending == 0) done.notify_one();
+        }
+    }
+};